@@ -0,0 +1,127 @@
+#include "BaselineStore.h"
+
+#define SNAPSHOT_MAGIC    0x54484D42  // "THMB"
+#define SNAPSHOT_VERSION  1
+#define NVS_NAMESPACE     "theremin"
+#define NVS_KEY_BASELINE  "baseline"
+
+// RTC慢速内存：不随复位初始化，由magic+crc判断有效性
+RTC_NOINIT_ATTR static BaselineSnapshot s_rtcSnapshot;
+
+// ========================================================
+// ======= 校验 ==========================================
+// ========================================================
+
+// FNV-1a (覆盖crc之前的所有字段)
+uint32_t BaselineStore::checksum(const BaselineSnapshot& snap) {
+    const uint8_t* p = (const uint8_t*)&snap;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < offsetof(BaselineSnapshot, crc); i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+bool BaselineStore::isValid(const BaselineSnapshot& snap) {
+    return snap.magic == SNAPSHOT_MAGIC &&
+           snap.version == SNAPSHOT_VERSION &&
+           snap.crc == checksum(snap) &&
+           snap.frozenBaseFreq > 1000.0f;
+}
+
+// ========================================================
+// ======= 读写 ==========================================
+// ========================================================
+
+BaselineStore::BaselineStore(const ThereminConfig& cfg) : m_cfg(cfg) {
+    m_pendingMux = portMUX_INITIALIZER_UNLOCKED;
+}
+
+bool BaselineStore::begin() {
+    m_nvsReady = m_prefs.begin(NVS_NAMESPACE, false);
+    if (!m_nvsReady) return false;
+    // 任务创建失败时仍可工作: 写入留在队列中，由调用方 flushPending()
+    xTaskCreatePinnedToCore(taskEntry, "NvsTask", m_cfg.snapshotNvsTaskStack, this,
+                            1, &m_task, m_cfg.snapshotNvsTaskCore);
+    return true;
+}
+
+bool BaselineStore::load(BaselineSnapshot& snap) {
+    if (isValid(s_rtcSnapshot)) {
+        snap = s_rtcSnapshot;
+        return true;
+    }
+
+    if (!m_nvsReady) return false;
+    if (m_prefs.getBytesLength(NVS_KEY_BASELINE) != sizeof(BaselineSnapshot)) return false;
+
+    BaselineSnapshot stored;
+    m_prefs.getBytes(NVS_KEY_BASELINE, &stored, sizeof(stored));
+    if (!isValid(stored)) return false;
+
+    m_lastNvsBaseFreq = stored.frozenBaseFreq;
+    m_nvsSavedOnce = true;
+    snap = stored;
+    return true;
+}
+
+void BaselineStore::save(const BaselineSnapshot& snap, unsigned long now, bool force) {
+    BaselineSnapshot sealed = snap;
+    sealed.magic = SNAPSHOT_MAGIC;
+    sealed.version = SNAPSHOT_VERSION;
+    sealed.crc = checksum(sealed);
+
+    // RTC: 仅受间隔限制
+    if (force || now - m_lastRtcSave >= m_cfg.snapshotRtcInterval) {
+        s_rtcSnapshot = sealed;
+        m_lastRtcSave = now;
+    }
+
+    // NVS: 时间节流 + 基线变化量门限，避免频繁擦写flash
+    if (!m_nvsReady) return;
+    bool changed = !m_nvsSavedOnce || m_nvsRetry ||
+                   fabs(sealed.frozenBaseFreq - m_lastNvsBaseFreq) >= m_cfg.snapshotNvsMinChange;
+    bool due = !m_nvsSavedOnce || now - m_lastNvsSave >= m_cfg.snapshotNvsInterval;
+    if (!changed || !(force || due)) return;
+
+    // 只排队，不等待写入；写入失败时由写入任务置 m_nvsRetry，下一次时间节流到期时重写
+    portENTER_CRITICAL(&m_pendingMux);
+    m_pending = sealed;
+    m_nvsPending = true;
+    m_nvsRetry = false;
+    portEXIT_CRITICAL(&m_pendingMux);
+    m_lastNvsSave = now;
+    m_lastNvsBaseFreq = sealed.frozenBaseFreq;
+    m_nvsSavedOnce = true;
+    if (m_task) xTaskNotifyGive(m_task);
+}
+
+void BaselineStore::flushPending() {
+    BaselineSnapshot snap;
+    portENTER_CRITICAL(&m_pendingMux);
+    bool pending = m_nvsPending;
+    snap = m_pending;
+    m_nvsPending = false;
+    portEXIT_CRITICAL(&m_pendingMux);
+    if (!pending) return;
+
+    if (m_prefs.putBytes(NVS_KEY_BASELINE, &snap, sizeof(snap)) == sizeof(snap)) {
+        m_nvsWrites++;
+    } else {
+        m_nvsFailures++;
+        portENTER_CRITICAL(&m_pendingMux);
+        if (!m_nvsPending) m_nvsRetry = true;   // 已有更新的快照排队时无需重试旧的
+        portEXIT_CRITICAL(&m_pendingMux);
+    }
+}
+
+void BaselineStore::taskEntry(void* arg) {
+    static_cast<BaselineStore*>(arg)->taskLoop();
+}
+
+void BaselineStore::taskLoop() {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        flushPending();
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef BASELINE_STORE_H
+#define BASELINE_STORE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+
+// ========================================================
+// ======= 基线快照 (Baseline Snapshot) ==================
+// ========================================================
+
+// 引擎热启动所需的最小状态集合
+struct BaselineSnapshot {
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    uint16_t envStableCounter = 0;  // 环境噪音统计
+    float frozenBaseFreq = 0;       // 已验证的冻结基线
+    float smoothedBaseFreq = 0;     // 已验证的平滑基线
+    float smoothedFreq = 0;         // 频率滤波状态
+    float lastRawFreq = 0;
+    float lastSmoothedDelta = 0;    // delta滤波状态
+    float lastStableDelta = 0;
+    int32_t envCount = 0;
+    uint32_t crc = 0;               // 必须放在最后 (不参与校验)
+};
+
+// ========================================================
+// ======= BaselineStore 类 =============================
+// ========================================================
+
+// 两级持久化：
+// - RTC内存: 写入无损耗，跨软件复位/看门狗/深度睡眠保留
+// - NVS: 跨断电保留，按时间间隔和基线变化量节流写入 (flash磨损)
+// save() 在采样路径上只更新RTC副本；NVS写入 (擦写可达数十毫秒) 交给低优先级任务
+class BaselineStore {
+public:
+    // cfg 须在存储生命周期内有效 (通常为所属引擎的配置)
+    explicit BaselineStore(const ThereminConfig& cfg);
+
+    // 打开NVS并启动写入任务
+    bool begin();
+
+    // 读取快照 (优先RTC，其次NVS)，无有效快照时返回false
+    bool load(BaselineSnapshot& snap);
+
+    // 周期保存；force=true 时跳过NVS时间节流 (手动校准)。不阻塞: NVS写入只排队
+    void save(const BaselineSnapshot& snap, unsigned long now, bool force = false);
+
+    // 执行排队的NVS写入。写入任务中调用；任务未启动时 (主机测试) 由调用方在采样路径之外调用
+    void flushPending();
+
+    bool hasPendingWrite() const { return m_nvsPending; }
+    uint32_t getNvsWriteCount() const { return m_nvsWrites; }
+    uint32_t getNvsFailureCount() const { return m_nvsFailures; }
+    TaskHandle_t getTaskHandle() const { return m_task; }
+
+private:
+    static uint32_t checksum(const BaselineSnapshot& snap);
+    static bool isValid(const BaselineSnapshot& snap);
+    static void taskEntry(void* arg);
+    void taskLoop();
+
+    const ThereminConfig& m_cfg;
+    Preferences m_prefs;
+    bool m_nvsReady = false;
+    unsigned long m_lastRtcSave = 0;
+
+    // 节流状态在排队时更新 (仅采样路径读写)
+    unsigned long m_lastNvsSave = 0;
+    bool m_nvsSavedOnce = false;
+    float m_lastNvsBaseFreq = 0;
+
+    // 采样路径 → 写入任务 (只保留最新一份)
+    TaskHandle_t m_task = NULL;
+    portMUX_TYPE m_pendingMux;
+    BaselineSnapshot m_pending;
+    volatile bool m_nvsPending = false;
+    volatile bool m_nvsRetry = false;       // 上次写入失败: 忽略变化量门限，到期即重写
+    volatile uint32_t m_nvsWrites = 0;
+    volatile uint32_t m_nvsFailures = 0;
+};
+
+#endif // BASELINE_STORE_H
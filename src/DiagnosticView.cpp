@@ -0,0 +1,63 @@
+#include "DiagnosticView.h"
+
+void DiagnosticView::setEnabled(bool enable, float baseFreq) {
+    if (enable == m_enabled) return;
+    m_enabled = enable;
+    m_display.clear();
+    if (enable) {
+        m_baseRef = baseFreq;
+        m_frames = 0;
+        m_maxRenderUs = 0;
+        m_statsStart = millis();
+    } else {
+        m_display.forceRefresh();
+    }
+}
+
+bool DiagnosticView::update(unsigned long now, float smoothedDelta, float baseFreq, bool jitter) {
+    if (!m_enabled || now - m_lastFrame < config.viewFrameMs) return false;
+    m_lastFrame = now;
+
+    uint32_t start = micros();
+    shiftIn(makeColumn(smoothedDelta, baseFreq, jitter));
+    m_lastRenderUs = micros() - start;
+    m_maxRenderUs = max(m_maxRenderUs, m_lastRenderUs);
+
+    m_display.flush();
+    m_frames++;
+    return true;
+}
+
+// bit r = 第 r 行 (0 为顶部)
+uint8_t DiagnosticView::makeColumn(float smoothedDelta, float baseFreq, bool jitter) const {
+    uint8_t column = jitter ? 0x01 : 0;
+
+    int height = constrain((int)lroundf(smoothedDelta / config.deltaFMax * 7), 0, 7);
+    for (int i = 0; i < height; i++) column |= 1 << (7 - i);
+
+    // 基线升高 → 点上移，中心为第4行
+    int offset = (int)lroundf((baseFreq - m_baseRef) / config.viewBaseCountsPerRow);
+    column |= 1 << constrain(4 - offset, 1, 7);
+    return column;
+}
+
+// 整个区域左移一列，新列从最右侧移入
+// 行字节 bit7 为模块最左列 (与 LedControl setRow 一致)，模块序号自左向右
+void DiagnosticView::shiftIn(uint8_t column) {
+    int modules = m_display.getModuleCount();
+    for (int row = 0; row < 8; row++) {
+        uint8_t incoming = (column >> row) & 1;
+        for (int m = 0; m < modules; m++) {
+            uint8_t carry = (m + 1 < modules) ? m_display.getRow(m + 1, row) >> 7 : incoming;
+            m_display.setRow(m, row, (uint8_t)(m_display.getRow(m, row) << 1) | carry);
+        }
+    }
+}
+
+void DiagnosticView::printStats() const {
+    float seconds = (millis() - m_statsStart) / 1000.0f;
+    Serial.printf("VIEW fps:%.1f render:%luus max:%luus flush:%dB/%luus\n",
+                  seconds > 0 ? m_frames / seconds : 0.0f,
+                  (unsigned long)m_lastRenderUs, (unsigned long)m_maxRenderUs,
+                  m_display.getLastFlushBytes(), (unsigned long)m_display.getLastFlushUs());
+}
@@ -0,0 +1,53 @@
+#ifndef DIAGNOSTIC_VIEW_H
+#define DIAGNOSTIC_VIEW_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "DisplayController.h"
+
+// ========================================================
+// ======= 诊断可视化 (Diagnostic View) ==================
+// ========================================================
+
+// 在整个点阵区域 (模块数 × 8 列, 8 行) 上从右向左滚动显示最近的信号:
+//   第0行       环境抖动标志
+//   第1-7行     smoothedDelta 柱状 (满量程 = deltaFMax)，自底向上
+//   第1-7行     基线轨迹点 (相对进入时的 frozenBaseFreq)
+// 每帧推入一列；像素直接存放在 DisplayController 帧缓冲中，按行标脏刷新。
+// 节省只按行计算: 滚动时任一模块有亮点的行都会变化，几乎整条链每帧都被重写；
+// 只有全空/不变的行被跳过。菊花链写一行时每个模块都要移入 2 字节 (不变的发 No-Op)，
+// 按模块标脏也省不下线上时间
+class DiagnosticView {
+public:
+    explicit DiagnosticView(DisplayController& display) : m_display(display) {}
+
+    // 进入时清屏并记录基线参考；退出时清屏并恢复眼睛显示
+    void setEnabled(bool enable, float baseFreq = 0);
+    bool isEnabled() const { return m_enabled; }
+
+    // 到达帧间隔时推入一列并刷新；返回是否渲染了新帧
+    bool update(unsigned long now, float smoothedDelta, float baseFreq, bool jitter);
+
+    void printStats() const;
+
+    // 统计 (本次进入以来)
+    uint32_t getFrameCount() const { return m_frames; }
+    uint32_t getLastRenderUs() const { return m_lastRenderUs; }
+    uint32_t getMaxRenderUs() const { return m_maxRenderUs; }
+
+private:
+    uint8_t makeColumn(float smoothedDelta, float baseFreq, bool jitter) const;
+    void shiftIn(uint8_t column);
+
+    DisplayController& m_display;
+    bool m_enabled = false;
+    unsigned long m_lastFrame = 0;
+    float m_baseRef = 0;
+
+    uint32_t m_frames = 0;
+    uint32_t m_lastRenderUs = 0;        // 移位 + 写帧缓冲 (不含传输)
+    uint32_t m_maxRenderUs = 0;
+    unsigned long m_statsStart = 0;
+};
+
+#endif // DIAGNOSTIC_VIEW_H
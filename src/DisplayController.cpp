@@ -18,28 +18,81 @@ const byte DisplayController::EYE_REAL_RIGHT[]   = { 0b00000000,0b01111110,0b100
 DisplayController::DisplayController() {}
 
 bool DisplayController::begin() {
-    m_lc = new LedControl(config.ledDinPin, config.ledClkPin, config.ledCsPin, config.ledModuleCount);
-    if (!m_lc) return false;
-    for(int i = 0; i < config.ledModuleCount; i++) {
-        m_lc->shutdown(i, false);
-        m_lc->setIntensity(i, 8);
-        m_lc->clearDisplay(i);
+    m_moduleCount = constrain(config.ledModuleCount, 1, LED_MODULE_MAX);
+    m_chainCount = constrain(config.ledChainCount, 1, LED_CHAIN_MAX);
+
+    // 模块按顺序平均分配到各链，余数给前面的链
+    const spi_host_device_t hosts[LED_CHAIN_MAX] = {SPI2_HOST, SPI3_HOST};
+    const int dinPins[LED_CHAIN_MAX] = {config.ledDinPin, config.ledChain2DinPin};
+    const int clkPins[LED_CHAIN_MAX] = {config.ledClkPin, config.ledChain2ClkPin};
+    const int csPins[LED_CHAIN_MAX] = {config.ledCsPin, config.ledChain2CsPin};
+    int start = 0;
+    for (int c = 0; c < m_chainCount; c++) {
+        int count = m_moduleCount / m_chainCount + (c < m_moduleCount % m_chainCount ? 1 : 0);
+        m_chainStart[c] = start;
+        for (int m = start; m < start + count; m++) m_moduleChain[m] = c;
+        if (!m_chains[c].begin(hosts[c], dinPins[c], clkPins[c], csPins[c], count)) return false;
+        start += count;
     }
+    m_chainStart[m_chainCount] = start;
+
+    writeAll(MAX7219_REG_INTENSITY, config.ledIntensity);
+    writeAll(MAX7219_REG_SHUTDOWN, 1);
+    m_ready = true;
     return true;
 }
 
-void DisplayController::displayEyes(const byte eyeL[], const byte eyeR[]) {
-    if (!m_lc) return;
-    for(int i = 0; i < 4; i++) {
-        for(int row = 0; row < 8; row++) m_lc->setRow(i, row, eyeL[row]);
-    }
-    for(int i = 4; i < 8; i++) {
-        for(int row = 0; row < 8; row++) m_lc->setRow(i, row, eyeR[row]);
+void DisplayController::writeAll(uint8_t reg, uint8_t value) {
+    for (int c = 0; c < m_chainCount; c++) m_chains[c].writeAll(reg, value);
+}
+
+// ========================================================
+// ======= 帧缓冲 ========================================
+// ========================================================
+
+void DisplayController::setRow(int module, int row, byte value) {
+    if (module < 0 || module >= m_moduleCount) return;
+    if (m_frame[module][row] == value) return;
+    m_frame[module][row] = value;
+    m_dirty[m_moduleChain[module]] |= 1 << row;
+}
+
+void DisplayController::setModule(int module, const byte rows[8]) {
+    for (int row = 0; row < 8; row++) setRow(module, row, rows[row]);
+}
+
+// 先为所有链排队，再统一等待，各链传输时间重叠
+// 只清除实际排队的脏行；排队失败的行保留，下次 flush 时补发
+void DisplayController::flush() {
+    if (!m_ready) return;
+    uint32_t start = micros();
+    int bytes = 0;
+    for (int c = 0; c < m_chainCount; c++) {
+        if (!m_dirty[c]) continue;
+        bytes += m_chains[c].queueRows(&m_frame[m_chainStart[c]], m_dirty[c]);
     }
+    if (!bytes) return;
+    for (int c = 0; c < m_chainCount; c++) m_chains[c].waitDone();
+    m_lastFlushBytes = bytes;
+    m_lastFlushUs = micros() - start;
 }
 
+// ========================================================
+// ======= 眼睛显示 ======================================
+// ========================================================
+
+// 前一半模块显示左眼，后一半显示右眼
+void DisplayController::displayEyes(const byte eyeL[], const byte eyeR[]) {
+    int half = m_moduleCount / 2;
+    for (int i = 0; i < m_moduleCount; i++) setModule(i, i < half ? eyeL : eyeR);
+    flush();
+}
 void DisplayController::updateEyes(int looking) {
-    if (looking == m_lastLooking) return;
+    if (m_powerSave) return;
+    if (looking == m_lastLooking) {
+        flush();                        // 补发上次排队失败的行 (无脏行时立即返回)
+        return;
+    }
     m_lastLooking = looking;
     
     switch(looking) {
@@ -61,6 +114,23 @@ void DisplayController::forceRefresh() {
 }
 
 void DisplayController::clear() {
-    if (!m_lc) return;
-    for(int i = 0; i < config.ledModuleCount; i++) m_lc->clearDisplay(i);
+    for (int i = 0; i < m_moduleCount; i++) {
+        for (int row = 0; row < 8; row++) setRow(i, row, 0);
+    }
+    flush();
+}
+
+void DisplayController::setPowerSave(bool enable) {
+    if (!m_ready || enable == m_powerSave) return;
+    m_powerSave = enable;
+    
+    if (!enable) {
+        writeAll(MAX7219_REG_SHUTDOWN, 1);
+        writeAll(MAX7219_REG_INTENSITY, config.ledIntensity);
+    } else if (config.idleDisplayIntensity < 0) {
+        writeAll(MAX7219_REG_SHUTDOWN, 0);
+    } else {
+        writeAll(MAX7219_REG_INTENSITY, config.idleDisplayIntensity);
+    }
+    if (!enable) forceRefresh();
 }
@@ -2,7 +2,7 @@
 #define DISPLAY_CONTROLLER_H
 
 #include <Arduino.h>
-#include "LedControl.h"
+#include "Max7219Chain.h"
 #include "config.h"
 
 class DisplayController {
@@ -22,6 +22,20 @@ public:
     
     void clear();
 
+    // 帧缓冲 API: 写入只标记脏行，flush() 时各链并行 DMA 刷新
+    int getModuleCount() const { return m_moduleCount; }
+    void setModule(int module, const byte rows[8]);
+    void setRow(int module, int row, byte value);
+    byte getRow(int module, int row) const { return m_frame[module][row]; }
+    void flush();
+
+    // 最近一次刷新的字节数与耗时 (微秒)
+    int getLastFlushBytes() const { return m_lastFlushBytes; }
+    uint32_t getLastFlushUs() const { return m_lastFlushUs; }
+
+    // 省电: 降低亮度或关闭模块 (config.idleDisplayIntensity)，退出时恢复并重绘
+    void setPowerSave(bool enable);
+
     // 图案定义
     static const byte EYE_OPEN[8];
     static const byte EYE_CLOSED[8];
@@ -35,8 +49,20 @@ public:
     static const byte EYE_REAL_RIGHT[8];
 
 private:
-    LedControl* m_lc = nullptr;
+    void writeAll(uint8_t reg, uint8_t value);
+
+    Max7219Chain m_chains[LED_CHAIN_MAX];
+    int m_chainCount = 0;
+    int m_chainStart[LED_CHAIN_MAX + 1] = {};   // 各链首模块在帧缓冲中的序号
+    uint8_t m_moduleChain[LED_MODULE_MAX] = {};
+    uint8_t m_dirty[LED_CHAIN_MAX] = {};        // 每链脏行掩码
+    uint8_t m_frame[LED_MODULE_MAX][8] = {};
+    int m_moduleCount = 0;
+    bool m_ready = false;
+    int m_lastFlushBytes = 0;
+    uint32_t m_lastFlushUs = 0;
     int m_lastLooking = -1;
+    bool m_powerSave = false;
 };
 
 #endif
@@ -0,0 +1,85 @@
+#include "GestureDetector.h"
+
+void GestureDetector::update(unsigned long now, float smoothedDelta, int direction) {
+    float slope = smoothedDelta - m_lastDelta;
+    m_lastDelta = smoothedDelta;
+
+    switch (m_phase) {
+        case PHASE_ABSENT:
+            if (smoothedDelta >= config.gesturePresenceOn) {
+                m_phase = PHASE_CANDIDATE;
+                m_startMs = now;
+                m_stillSinceMs = now;
+                m_peakDelta = smoothedDelta;
+                m_hoverEmitted = false;
+            }
+            break;
+
+        case PHASE_CANDIDATE:
+            if (smoothedDelta < config.gesturePresenceOff) {
+                m_phase = PHASE_ABSENT;
+                m_rejected++;
+                break;
+            }
+            m_peakDelta = fmaxf(m_peakDelta, smoothedDelta);
+            if (now - m_startMs >= config.gestureMinMs) {
+                m_phase = PHASE_PRESENT;
+                emit(GESTURE_APPROACH, now, direction);
+            }
+            break;
+
+        case PHASE_PRESENT:
+            if (smoothedDelta < config.gesturePresenceOff) {
+                unsigned long duration = now - m_startMs;
+                GestureType type = GESTURE_WITHDRAW;
+                if (duration <= config.gestureShortMs) {
+                    type = (m_peakDelta >= config.gestureTapPeak) ? GESTURE_TAP : GESTURE_SWIPE;
+                }
+                emit(type, now, direction);
+                m_phase = PHASE_ABSENT;
+                break;
+            }
+            m_peakDelta = fmaxf(m_peakDelta, smoothedDelta);
+
+            // 悬停：斜率持续低于阈值；移动后重新计时并允许再次触发
+            if (fabs(slope) > config.gestureHoverSlope) {
+                m_stillSinceMs = now;
+                m_hoverEmitted = false;
+            } else if (!m_hoverEmitted && now - m_stillSinceMs >= config.gestureHoverMs) {
+                emit(GESTURE_HOVER, now, direction);
+                m_hoverEmitted = true;
+            }
+            break;
+    }
+}
+
+void GestureDetector::reset() {
+    m_phase = PHASE_ABSENT;
+    m_lastDelta = 0;
+    m_peakDelta = 0;
+    m_hoverEmitted = false;
+}
+
+void GestureDetector::emit(GestureType type, unsigned long now, int direction) {
+    m_eventCounts[type]++;
+    if (!m_callback) return;
+
+    GestureEvent ev;
+    ev.type = type;
+    ev.direction = (int8_t)direction;
+    ev.timestampMs = now;
+    ev.durationMs = now - m_startMs;
+    ev.peakDelta = m_peakDelta;
+    m_callback(ev);
+}
+
+const char* GestureDetector::typeName(GestureType type) {
+    switch (type) {
+        case GESTURE_APPROACH: return "approach";
+        case GESTURE_WITHDRAW: return "withdraw";
+        case GESTURE_HOVER:    return "hover";
+        case GESTURE_SWIPE:    return "swipe";
+        case GESTURE_TAP:      return "tap";
+        default:               return "none";
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef GESTURE_DETECTOR_H
+#define GESTURE_DETECTOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ========================================================
+// ======= 手势事件 (Gesture Events) =====================
+// ========================================================
+
+enum GestureType : uint8_t {
+    GESTURE_NONE = 0,
+    GESTURE_APPROACH,   // 手进入感应范围
+    GESTURE_WITHDRAW,   // 手离开 (长停留之后)
+    GESTURE_HOVER,      // 手在范围内保持静止
+    GESTURE_SWIPE,      // 快速掠过 (短时、峰值低)
+    GESTURE_TAP,        // 快速点按 (短时、峰值高)
+    GESTURE_TYPE_COUNT
+};
+
+struct GestureEvent {
+    GestureType type = GESTURE_NONE;
+    int8_t direction = 0;           // 事件时刻的频率变化方向 (-1, 0, 1)
+    unsigned long timestampMs = 0;  // 检测时刻
+    unsigned long durationMs = 0;   // 自手出现起的持续时间
+    float peakDelta = 0;            // 本次手势的峰值delta
+};
+
+typedef void (*GestureCallback)(const GestureEvent& event);
+
+// ========================================================
+// ======= GestureDetector 类 ===========================
+// ========================================================
+
+// 基于平滑delta的增量式手势检测：每样本O(1)，无历史缓冲
+// ABSENT --delta>=presenceOn--> CANDIDATE --持续gestureMinMs--> PRESENT (APPROACH)
+// PRESENT --斜率持续很小--> HOVER (每次停留仅一次)
+// PRESENT --delta<presenceOff--> 按持续时间/峰值分类为 TAP / SWIPE / WITHDRAW
+class GestureDetector {
+public:
+    void setCallback(GestureCallback cb) { m_callback = cb; }
+
+    // 每个新样本调用一次
+    void update(unsigned long now, float smoothedDelta, int direction);
+
+    void reset();
+
+    static const char* typeName(GestureType type);
+    uint32_t getEventCount(GestureType type) const { return m_eventCounts[type]; }
+    uint32_t getRejectedCount() const { return m_rejected; }
+
+private:
+    enum Phase : uint8_t { PHASE_ABSENT, PHASE_CANDIDATE, PHASE_PRESENT };
+
+    void emit(GestureType type, unsigned long now, int direction);
+
+    GestureCallback m_callback = nullptr;
+    Phase m_phase = PHASE_ABSENT;
+
+    // 特征 (增量更新)
+    float m_lastDelta = 0;
+    float m_peakDelta = 0;
+    unsigned long m_startMs = 0;
+    unsigned long m_stillSinceMs = 0;
+    bool m_hoverEmitted = false;
+
+    // 统计
+    uint32_t m_eventCounts[GESTURE_TYPE_COUNT] = {0};
+    uint32_t m_rejected = 0;        // 短于 gestureMinMs 被丢弃的候选
+};
+
+#endif // GESTURE_DETECTOR_H
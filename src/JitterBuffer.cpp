@@ -0,0 +1,140 @@
+#include "JitterBuffer.h"
+
+// ========================================================
+// ======= 接收 ==========================================
+// ========================================================
+
+void JitterBuffer::push(const PlayoutSample& sample, unsigned long arrivalMs) {
+    m_stats.received++;
+    if (m_offsetValid && isDiscontinuity(sample)) resync();
+    if (!m_offsetValid || seqBefore(m_newestSeq, sample.seq)) {
+        m_newestSeq = sample.seq;
+        m_newestSenderMs = sample.senderMs;
+    }
+    updateClock((int32_t)(arrivalMs - sample.senderMs), arrivalMs);
+
+    // 已播放过的序号: 迟到或重复
+    if (m_started && !seqBefore(m_current.seq, sample.seq)) {
+        if (sample.seq == m_current.seq) m_stats.duplicates++;
+        else m_stats.late++;
+        return;
+    }
+
+    // 按序号插入 (处理乱序)
+    int pos = m_count;
+    while (pos > 0 && seqBefore(sample.seq, m_buf[pos - 1].seq)) pos--;
+    if (pos > 0 && m_buf[pos - 1].seq == sample.seq) {
+        m_stats.duplicates++;
+        return;
+    }
+    if (m_count == CAPACITY) {
+        // 缓冲满: 丢弃最旧样本
+        if (pos == 0) {
+            m_stats.overflow++;
+            return;
+        }
+        memmove(&m_buf[0], &m_buf[1], (CAPACITY - 1) * sizeof(PlayoutSample));
+        m_count--;
+        pos--;
+        m_stats.overflow++;
+    }
+    memmove(&m_buf[pos + 1], &m_buf[pos], (m_count - pos) * sizeof(PlayoutSample));
+    m_buf[pos] = sample;
+    m_count++;
+}
+
+// 发送端重启后序号从0、时间戳从启动时刻重新开始: 序号大幅回退，或 (旧序号已超过半圈时) 时间戳回退。
+// 正常的乱序/迟到只在缓冲容量量级内，不会触发；断连后序号前跳不需要重新同步
+bool JitterBuffer::isDiscontinuity(const PlayoutSample& sample) const {
+    int seqStep = (int16_t)(sample.seq - m_newestSeq);
+    int32_t timeStep = (int32_t)(sample.senderMs - m_newestSenderMs);
+    return seqStep < -config.playoutResyncSeq || timeStep < -(int32_t)config.playoutResyncMs;
+}
+
+// 丢弃旧流的缓冲与时钟估计，下一个样本作为新流的起点 (保持当前输出直到新样本到达播放点)
+void JitterBuffer::resync() {
+    m_count = 0;
+    m_started = false;
+    m_offsetValid = false;
+    m_stats.jitterMs = 0;
+    m_stats.resyncs++;
+}
+
+void JitterBuffer::updateClock(int32_t transit, unsigned long arrivalMs) {
+    // 最小传输时间 (含两端时钟差)，分段窗口以跟随晶振漂移
+    if (!m_offsetValid) {
+        m_offsetCur = m_offsetPrev = transit;
+        m_windowStart = arrivalMs;
+        m_lastTransit = transit;
+        m_stats.delayMs = config.playoutMinDelayMs;
+        m_offsetValid = true;
+        return;
+    }
+    if (arrivalMs - m_windowStart > config.playoutOffsetWindowMs) {
+        m_offsetPrev = m_offsetCur;
+        m_offsetCur = transit;
+        m_windowStart = arrivalMs;
+    } else {
+        m_offsetCur = min(m_offsetCur, transit);
+    }
+
+    // RFC 3550 抖动估计: J += (|D| - J) / 16
+    float d = fabs((float)(transit - m_lastTransit));
+    m_lastTransit = transit;
+    m_stats.jitterMs += (d - m_stats.jitterMs) / 16.0f;
+
+    // 播放延迟缓慢趋向目标，避免播放时钟跳变
+    float target = config.playoutMinDelayMs + config.playoutJitterGain * m_stats.jitterMs;
+    target = constrain(target, (float)config.playoutMinDelayMs, (float)config.playoutMaxDelayMs);
+    m_stats.delayMs += (target - m_stats.delayMs) * 0.05f;
+}
+
+// ========================================================
+// ======= 播放 ==========================================
+// ========================================================
+
+bool JitterBuffer::playout(unsigned long nowMs, PlayoutFrame& out) {
+    if (!m_offsetValid) return false;
+
+    int32_t offset = min(m_offsetCur, m_offsetPrev);
+    uint32_t playMs = (uint32_t)(nowMs - offset - (int32_t)m_stats.delayMs);
+
+    // 推进到播放时刻之前的最新样本
+    while (m_count > 0 && (int32_t)(m_buf[0].senderMs - playMs) <= 0) {
+        if (m_started) {
+            m_stats.lost += (uint16_t)(m_buf[0].seq - m_current.seq - 1);
+        }
+        m_current = m_buf[0];
+        m_started = true;
+        memmove(&m_buf[0], &m_buf[1], (m_count - 1) * sizeof(PlayoutSample));
+        m_count--;
+    }
+    if (!m_started) return false;
+
+    out.looking = m_current.looking;
+    out.duty = m_current.duty;
+    out.direction = m_current.direction;
+    out.concealed = false;
+
+    // 序号缺口: 在缺口两端之间线性插值
+    if (m_count > 0 && m_buf[0].seq != (uint16_t)(m_current.seq + 1)) {
+        const PlayoutSample& next = m_buf[0];
+        int32_t span = (int32_t)(next.senderMs - m_current.senderMs);
+        if (span > 0) {
+            float t = (float)(int32_t)(playMs - m_current.senderMs) / span;
+            t = constrain(t, 0.0f, 1.0f);
+            out.looking = lroundf(m_current.looking + t * (next.looking - m_current.looking));
+            out.duty = lroundf(m_current.duty + t * (next.duty - m_current.duty));
+            out.concealed = true;
+        }
+    }
+
+    m_stats.ticks++;
+    if (out.concealed) m_stats.concealedTicks++;
+    if (m_lastLooking >= 0 && out.looking != m_lastLooking) {
+        m_stats.lookingChanges++;
+        if (abs(out.looking - m_lastLooking) > 1) m_stats.lookingJumps++;
+    }
+    m_lastLooking = out.looking;
+    return true;
+}
@@ -0,0 +1,87 @@
+#ifndef JITTER_BUFFER_H
+#define JITTER_BUFFER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ========================================================
+// ======= 接收端抖动缓冲 (Jitter Buffer) ================
+// ========================================================
+
+// 收到的状态样本 (发送端时间戳)
+struct PlayoutSample {
+    uint16_t seq = 0;
+    uint32_t senderMs = 0;
+    int looking = 0;
+    int duty = 0;
+    int direction = 0;
+};
+
+// 播放时钟每拍的输出
+struct PlayoutFrame {
+    int looking = 0;
+    int duty = 0;
+    int direction = 0;
+    bool concealed = false;         // 丢包区间内插值得到
+};
+
+struct JitterStats {
+    uint32_t received = 0;
+    uint32_t late = 0;              // 晚于播放点到达而丢弃
+    uint32_t duplicates = 0;
+    uint32_t overflow = 0;          // 缓冲满丢弃最旧样本
+    uint32_t lost = 0;              // 序号缺口 (未到达)
+    uint32_t ticks = 0;             // 播放拍数
+    uint32_t concealedTicks = 0;
+    uint32_t lookingChanges = 0;    // 输出 looking 变化次数
+    uint32_t lookingJumps = 0;      // 单拍变化超过1级 (不平滑)
+    uint32_t resyncs = 0;           // 发送端重启/断连后的重新同步次数
+    float jitterMs = 0;             // 到达间隔抖动估计
+    float delayMs = 0;              // 当前播放延迟
+};
+
+// 发送端只在数据变化时发包 (值在两包之间保持)，因此:
+// - 播放时刻 = 发送时间戳 + 时钟偏移 (最小传输时间) + 自适应播放延迟
+// - 相邻序号之间保持前值；序号缺口处在两端样本之间线性插值 (丢包隐藏)
+// - 播放延迟按 RFC 3550 式抖动估计自适应
+// - 序号大幅回退或发送端时间戳回退 (发送端重启) 时清空缓冲，按新的序号/时钟重新同步
+// 非线程安全：push (ESP-NOW回调) 与 playout (主循环) 须由调用方加锁
+class JitterBuffer {
+public:
+    static const int CAPACITY = JITTER_BUFFER_SIZE;
+
+    void push(const PlayoutSample& sample, unsigned long arrivalMs);
+
+    // 每个播放拍调用；尚未收到任何样本时返回false
+    bool playout(unsigned long nowMs, PlayoutFrame& out);
+
+    const JitterStats& getStats() const { return m_stats; }
+
+private:
+    static bool seqBefore(uint16_t a, uint16_t b) { return (int16_t)(a - b) < 0; }
+    bool isDiscontinuity(const PlayoutSample& sample) const;
+    void resync();
+    void updateClock(int32_t transit, unsigned long arrivalMs);
+
+    PlayoutSample m_buf[CAPACITY];  // 按序号升序
+    int m_count = 0;
+
+    PlayoutSample m_current;        // 当前正在播放的样本
+    bool m_started = false;
+    int m_lastLooking = -1;
+
+    // 已收到的最新样本 (按序号)，用于检测发送端重启
+    uint16_t m_newestSeq = 0;
+    uint32_t m_newestSenderMs = 0;
+
+    // 时钟偏移: 两段窗口的最小传输时间
+    bool m_offsetValid = false;
+    int32_t m_offsetCur = 0;
+    int32_t m_offsetPrev = 0;
+    unsigned long m_windowStart = 0;
+    int32_t m_lastTransit = 0;
+
+    JitterStats m_stats;
+};
+
+#endif // JITTER_BUFFER_H
@@ -0,0 +1,82 @@
+#include "Max7219Chain.h"
+#include "esp_heap_caps.h"
+
+bool Max7219Chain::begin(spi_host_device_t host, int dinPin, int clkPin, int csPin, int moduleCount) {
+    m_modules = moduleCount;
+
+    spi_bus_config_t bus = {};
+    bus.mosi_io_num = dinPin;
+    bus.miso_io_num = -1;
+    bus.sclk_io_num = clkPin;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    bus.max_transfer_sz = 2 * moduleCount;
+    if (spi_bus_initialize(host, &bus, SPI_DMA_CH_AUTO) != ESP_OK) return false;
+
+    spi_device_interface_config_t dev = {};
+    dev.mode = 0;
+    dev.clock_speed_hz = config.ledSpiClockHz;
+    dev.spics_io_num = csPin;
+    dev.queue_size = 8;
+    if (spi_bus_add_device(host, &dev, &m_dev) != ESP_OK) return false;
+
+    m_tx = (uint8_t*)heap_caps_malloc(8 * 2 * moduleCount, MALLOC_CAP_DMA);
+    if (!m_tx) return false;
+
+    writeAll(MAX7219_REG_DISPLAYTEST, 0);
+    writeAll(MAX7219_REG_SCANLIMIT, 7);
+    writeAll(MAX7219_REG_DECODE, 0);
+    for (int row = 0; row < 8; row++) writeAll(MAX7219_REG_DIGIT0 + row, 0);
+    return true;
+}
+
+void Max7219Chain::writeAll(uint8_t reg, uint8_t value) {
+    if (!m_dev) return;
+    waitDone();
+    for (int i = 0; i < m_modules; i++) {
+        m_tx[2 * i] = reg;
+        m_tx[2 * i + 1] = value;
+    }
+    spi_transaction_t t = {};
+    t.length = 16 * m_modules;
+    t.tx_buffer = m_tx;
+    spi_device_polling_transmit(m_dev, &t);
+}
+
+// 先移出的数据到达链的最远端，因此从最后一个模块开始填充
+void Max7219Chain::fillRow(uint8_t* tx, uint8_t reg, const uint8_t (*rows)[8], int row) {
+    for (int m = m_modules - 1; m >= 0; m--) {
+        *tx++ = reg;
+        *tx++ = rows[m][row];
+    }
+}
+
+int Max7219Chain::queueRows(const uint8_t (*rows)[8], uint8_t& dirtyMask) {
+    if (!m_dev || !dirtyMask) return 0;
+    waitDone();
+
+    int bytes = 0;
+    for (int row = 0; row < 8; row++) {
+        if (!(dirtyMask & (1 << row))) continue;
+        uint8_t* tx = m_tx + row * 2 * m_modules;
+        fillRow(tx, MAX7219_REG_DIGIT0 + row, rows, row);
+
+        spi_transaction_t& t = m_trans[m_pending];
+        memset(&t, 0, sizeof(t));
+        t.length = 16 * m_modules;
+        t.tx_buffer = tx;
+        if (spi_device_queue_trans(m_dev, &t, 0) != ESP_OK) break;
+        m_pending++;
+        dirtyMask &= ~(1 << row);
+        bytes += 2 * m_modules;
+    }
+    return bytes;
+}
+
+void Max7219Chain::waitDone() {
+    spi_transaction_t* done;
+    while (m_pending > 0) {
+        spi_device_get_trans_result(m_dev, &done, portMAX_DELAY);
+        m_pending--;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef MAX7219_CHAIN_H
+#define MAX7219_CHAIN_H
+
+#include <Arduino.h>
+#include "driver/spi_master.h"
+#include "config.h"
+
+// ========================================================
+// ======= MAX7219 寄存器 ================================
+// ========================================================
+
+#define MAX7219_REG_NOOP        0x00
+#define MAX7219_REG_DIGIT0      0x01    // 行0..7 = 0x01..0x08
+#define MAX7219_REG_DECODE      0x09
+#define MAX7219_REG_INTENSITY   0x0A
+#define MAX7219_REG_SCANLIMIT   0x0B
+#define MAX7219_REG_SHUTDOWN    0x0C
+#define MAX7219_REG_DISPLAYTEST 0x0F
+
+// ========================================================
+// ======= Max7219Chain 类 ===============================
+// ========================================================
+
+// 一条 MAX7219 菊花链，独占一个 SPI 主机，CS 由硬件控制 (上升沿锁存)
+// 模块编号与 LedControl 一致: 模块0离 MCU 最近 (每次传输最后移出)
+// 行刷新通过 DMA 排队，queueRows() 立即返回，多条链可并行传输
+class Max7219Chain {
+public:
+    bool begin(spi_host_device_t host, int dinPin, int clkPin, int csPin, int moduleCount);
+
+    int getModuleCount() const { return m_modules; }
+
+    // 同一寄存器写入链上所有模块 (阻塞，用于初始化/亮度/关断)
+    void writeAll(uint8_t reg, uint8_t value);
+
+    // 排队写入 dirtyMask 中的行；rows[m] 为本链第 m 个模块的8行数据
+    // 成功排队的行从 dirtyMask 中清除 (队列满时其余行保留，留待下次刷新)
+    // 返回排队的字节数；须在下次写入前调用 waitDone()
+    int queueRows(const uint8_t (*rows)[8], uint8_t& dirtyMask);
+    void waitDone();
+
+private:
+    void fillRow(uint8_t* tx, uint8_t reg, const uint8_t (*rows)[8], int row);
+
+    spi_device_handle_t m_dev = NULL;
+    int m_modules = 0;
+    uint8_t* m_tx = nullptr;            // DMA缓冲: 8行 × 2字节 × 模块数
+    spi_transaction_t m_trans[8];
+    int m_pending = 0;
+};
+
+#endif // MAX7219_CHAIN_H
@@ -0,0 +1,44 @@
+#include "OutputQuantizer.h"
+
+void OutputQuantizer::update(unsigned long now, float smoothedLooking, int duty) {
+    int rawLooking = constrain((int)smoothedLooking, 0, 8);
+    int looking = m_cfg.enableOutputQuantizer ? quantizeLooking(now, smoothedLooking) : rawLooking;
+    int q = m_cfg.enableOutputQuantizer ? quantizeDuty(duty) : duty;
+
+    if (looking != m_looking) {
+        m_stats.lookingEmitted++;
+        m_lastChangeMs = now;
+    } else if (rawLooking != m_rawLooking) {
+        m_stats.lookingSuppressed++;
+    }
+    if (q != m_duty) m_stats.dutyEmitted++;
+    else if (duty != m_rawDuty) m_stats.dutySuppressed++;
+
+    m_looking = looking;
+    m_duty = q;
+    m_rawLooking = rawLooking;
+    m_rawDuty = duty;
+}
+
+// 当前级 L 的保持区间为 [L - h, L + 1 + h)，越出后才考虑切换
+int OutputQuantizer::quantizeLooking(unsigned long now, float smoothedLooking) {
+    float h = m_cfg.quantLookingHysteresis;
+    if (smoothedLooking >= m_looking - h && smoothedLooking < m_looking + 1 + h) return m_looking;
+    if (now - m_lastChangeMs < m_cfg.quantMinDwellMs) return m_looking;
+
+    int target = constrain((int)smoothedLooking, 0, 8);
+    int step = target - m_looking;
+    int maxStep = m_cfg.quantLookingMaxStep;
+    if (maxStep > 0) step = constrain(step, -maxStep, maxStep);
+    return m_looking + step;
+}
+
+int OutputQuantizer::quantizeDuty(int duty) {
+    int diff = duty - m_duty;
+    bool endpoint = (duty == 0 || duty == 255) && diff != 0;
+    if (!endpoint && abs(diff) <= m_cfg.quantDutyHysteresis) return m_duty;
+
+    int slew = m_cfg.quantDutySlew;
+    if (slew > 0) diff = constrain(diff, -slew, slew);
+    return m_duty + diff;
+}
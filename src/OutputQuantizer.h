@@ -0,0 +1,46 @@
+#ifndef OUTPUT_QUANTIZER_H
+#define OUTPUT_QUANTIZER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ========================================================
+// ======= 输出量化 (Output Quantizer) ===================
+// ========================================================
+
+struct QuantizerStats {
+    uint32_t lookingEmitted = 0;        // 量化后 looking 变化次数 (= 显示刷新/无线发包)
+    uint32_t lookingSuppressed = 0;     // 原始 looking 变化但被滞回/驻留/限速拦下
+    uint32_t dutyEmitted = 0;
+    uint32_t dutySuppressed = 0;
+};
+
+// 引擎与输出消费者 (显示、PWM、ESP-NOW) 之间的输出级:
+// - looking: 滞回带 + 最短驻留时间 + 每次切换最大级数
+// - duty: 滞回带 + 每样本最大变化 (到达 0/255 端点时总是输出)
+// 关闭 enableOutputQuantizer 时直通 (与原截断行为一致)
+class OutputQuantizer {
+public:
+    explicit OutputQuantizer(const ThereminConfig& cfg = config) : m_cfg(cfg) {}
+
+    // 每样本调用；smoothedLooking 为平滑后的连续值 (0-8)
+    void update(unsigned long now, float smoothedLooking, int duty);
+
+    int getLooking() const { return m_looking; }
+    int getDuty() const { return m_duty; }
+    const QuantizerStats& getStats() const { return m_stats; }
+
+private:
+    int quantizeLooking(unsigned long now, float smoothedLooking);
+    int quantizeDuty(int duty);
+
+    const ThereminConfig& m_cfg;
+    int m_looking = 0;
+    int m_duty = 0;
+    int m_rawLooking = 0;
+    int m_rawDuty = 0;
+    unsigned long m_lastChangeMs = 0;
+    QuantizerStats m_stats;
+};
+
+#endif // OUTPUT_QUANTIZER_H
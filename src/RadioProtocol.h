@@ -0,0 +1,60 @@
+#ifndef RADIO_PROTOCOL_H
+#define RADIO_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ========================================================
+// ======= ESP-NOW 消息格式 =============================
+// ========================================================
+// 接收端按包长区分消息类型
+
+// 状态消息 (12字节，旧版发送端)
+typedef struct __attribute__((packed)) struct_message {
+    int a;  // looking (0-8)
+    int b;  // PWM duty (0-255)
+    int c;  // direction (-1, 0, 1)
+} struct_message;
+
+// 带序号与时间戳的状态消息 (18字节，需 ENABLE_STATE_SEQ 开启发送)
+// 前12字节与 struct_message 相同。按 len == 12 校验包长的旧接收端会丢弃每一个 18 字节包，
+// 因此默认只发送前12字节 (旧格式)；接收端刷写本版本固件后再开启
+typedef struct __attribute__((packed)) state_message {
+    int a;
+    int b;
+    int c;
+    uint16_t seq;           // 每发送一包 +1，接收端据此检测丢包与乱序
+    uint32_t timestampMs;   // 发送端采样时刻 millis()
+} state_message;
+
+static_assert(offsetof(state_message, seq) == sizeof(struct_message),
+              "state_message must start with struct_message");
+
+// 手势事件消息 (14字节，需 ENABLE_GESTURE_RADIO 开启发送)
+// 长度与 12/18 字节状态消息都不同，按长度校验的旧接收端会直接丢弃；
+// 新接收端还须校验 magic + version。不校验长度的旧接收端仍会误读，因此默认不发送
+#define GESTURE_MSG_MAGIC    'G'
+#define GESTURE_MSG_VERSION  1
+
+typedef struct __attribute__((packed)) gesture_message {
+    uint8_t magic;          // GESTURE_MSG_MAGIC
+    uint8_t version;        // GESTURE_MSG_VERSION
+    uint8_t type;           // GestureType
+    int8_t direction;
+    uint16_t seq;           // 每个手势事件 +1，接收端据此检测丢失的事件
+    uint32_t timestampMs;   // 发送端 millis()
+    uint16_t durationMs;
+    uint16_t peakDeltaX10;  // 峰值delta × 10
+} gesture_message;
+
+static_assert(sizeof(gesture_message) != sizeof(struct_message) &&
+              sizeof(gesture_message) != sizeof(state_message),
+              "gesture_message length must differ from state messages");
+
+// 接收端校验: 长度、magic 与版本都匹配才按手势解析
+inline bool isGestureMessage(const uint8_t* data, int len) {
+    return len == (int)sizeof(gesture_message) && data[0] == GESTURE_MSG_MAGIC &&
+           data[1] == GESTURE_MSG_VERSION;
+}
+
+#endif // RADIO_PROTOCOL_H
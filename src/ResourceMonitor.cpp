@@ -0,0 +1,84 @@
+#include "ResourceMonitor.h"
+#include <atomic>
+#include <new>
+#include "esp_heap_caps.h"
+
+ResourceMonitor resources;
+
+// operator new 可在任意任务/核心中调用，状态放在文件作用域
+static std::atomic<bool> s_armed(false);
+static std::atomic<uint32_t> s_postInitAllocs(0);
+static std::atomic<uint32_t> s_lastAllocSize(0);
+static uint8_t s_policy = RESOURCE_ALLOC_POLICY;
+
+// ========================================================
+// ======= 全局 operator new 替换 ========================
+// ========================================================
+
+void* operator new(size_t size) {
+    if (s_armed.load(std::memory_order_relaxed) && s_policy != ALLOC_POLICY_IGNORE) {
+        s_postInitAllocs.fetch_add(1, std::memory_order_relaxed);
+        s_lastAllocSize.store(size, std::memory_order_relaxed);
+        if (s_policy == ALLOC_POLICY_ABORT) abort();
+    }
+    void* p = malloc(size);
+#if __cpp_exceptions
+    if (!p) throw std::bad_alloc();
+#else
+    if (!p) abort();
+#endif
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// ========================================================
+// ======= ResourceMonitor ===============================
+// ========================================================
+
+void ResourceMonitor::begin() {
+    s_policy = config.resourceAllocPolicy;
+}
+
+void ResourceMonitor::registerTask(TaskHandle_t handle, const char* name, uint32_t stackBytes) {
+    if (m_taskCount >= MAX_TASKS) return;
+    TaskBudget& t = m_tasks[m_taskCount++];
+    t.handle = handle ? handle : xTaskGetCurrentTaskHandle();
+    t.name = name;
+    t.stackBytes = stackBytes;
+}
+
+void ResourceMonitor::markInitDone() {
+    s_armed = true;
+}
+
+uint32_t ResourceMonitor::getPostInitAllocCount() const {
+    return s_postInitAllocs;
+}
+
+void ResourceMonitor::printReport() const {
+    size_t freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    size_t minFree = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    int frag = freeBytes ? 100 - (int)(largest * 100 / freeBytes) : 0;
+
+    Serial.printf("RES heap free:%u min:%u largest:%u frag:%d%% | new after init:%lu (last %luB)\n",
+                  (unsigned)freeBytes, (unsigned)minFree, (unsigned)largest, frag,
+                  (unsigned long)s_postInitAllocs.load(), (unsigned long)s_lastAllocSize.load());
+
+    // ESP-IDF 中栈以字节计，高水位即历史最少剩余字节
+    for (int i = 0; i < m_taskCount; i++) {
+        const TaskBudget& t = m_tasks[i];
+        uint32_t headroom = uxTaskGetStackHighWaterMark(t.handle);
+        Serial.printf("RES task %-14s stack:%5lu used:%5lu free:%5lu\n", t.name,
+                      (unsigned long)t.stackBytes, (unsigned long)(t.stackBytes - headroom),
+                      (unsigned long)headroom);
+    }
+}
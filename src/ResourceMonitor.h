@@ -0,0 +1,50 @@
+#ifndef RESOURCE_MONITOR_H
+#define RESOURCE_MONITOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ========================================================
+// ======= 资源监控 (Resource Monitor) ===================
+// ========================================================
+
+// setup() 之后的 operator new 处理策略 (RESOURCE_ALLOC_POLICY)
+enum AllocPolicy : uint8_t {
+    ALLOC_POLICY_IGNORE = 0,    // 不计数
+    ALLOC_POLICY_COUNT = 1,     // 计数，随报告输出
+    ALLOC_POLICY_ABORT = 2      // 视为硬错误，立即 abort (panic 回溯指向分配点)
+};
+
+struct TaskBudget {
+    TaskHandle_t handle = NULL;
+    const char* name = "";
+    uint32_t stackBytes = 0;        // 创建时的栈大小
+};
+
+// 周期报告: 各任务栈高水位 (剩余最少字节)、堆剩余/历史最低/最大连续块、
+// setup() 之后的 C++ 动态分配次数
+// 只统计 operator new/new[]；C 库 malloc (WiFi/ESP-NOW 内部) 不在统计范围
+class ResourceMonitor {
+public:
+    static const int MAX_TASKS = 8;
+
+    void begin();
+
+    // 在 setup() 中登记要监控的任务 (NULL = 当前任务)
+    void registerTask(TaskHandle_t handle, const char* name, uint32_t stackBytes);
+
+    // setup() 结束时调用，此后按策略处理 operator new
+    void markInitDone();
+
+    uint32_t getPostInitAllocCount() const;
+    void printReport() const;
+
+private:
+    TaskBudget m_tasks[MAX_TASKS];
+    int m_taskCount = 0;
+};
+
+// 全局资源监控实例
+extern ResourceMonitor resources;
+
+#endif // RESOURCE_MONITOR_H
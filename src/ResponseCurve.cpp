@@ -0,0 +1,125 @@
+#include "ResponseCurve.h"
+
+#define CURVE_MAGIC       0x54484D43  // "THMC"
+#define CURVE_VERSION     1
+#define NVS_NAMESPACE     "theremin"
+#define NVS_KEY_CURVE     "curve"
+
+// NVS存储格式
+struct CurveRecord {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    float minDelta;
+    float maxDelta;
+    uint8_t table[CURVE_LUT_SIZE];
+};
+
+// ========================================================
+// ======= 存储 ==========================================
+// ========================================================
+
+bool ResponseCurve::begin() {
+    m_nvsReady = m_prefs.begin(NVS_NAMESPACE, false);
+    if (!m_nvsReady) return false;
+    if (m_prefs.getBytesLength(NVS_KEY_CURVE) != sizeof(CurveRecord)) return false;
+
+    CurveRecord rec;
+    m_prefs.getBytes(NVS_KEY_CURVE, &rec, sizeof(rec));
+    if (rec.magic != CURVE_MAGIC || rec.version != CURVE_VERSION ||
+        rec.size != LUT_SIZE || !(rec.minDelta >= 0) || !(rec.maxDelta > rec.minDelta)) {
+        return false;
+    }
+
+    memcpy(m_table, rec.table, sizeof(m_table));
+    setRange(rec.minDelta, rec.maxDelta);
+    m_valid = true;
+    return true;
+}
+
+bool ResponseCurve::save() {
+    if (!m_nvsReady || !m_valid) return false;
+
+    CurveRecord rec;
+    rec.magic = CURVE_MAGIC;
+    rec.version = CURVE_VERSION;
+    rec.size = LUT_SIZE;
+    rec.minDelta = m_minDelta;
+    rec.maxDelta = m_maxDelta;
+    memcpy(rec.table, m_table, sizeof(rec.table));
+    return m_prefs.putBytes(NVS_KEY_CURVE, &rec, sizeof(rec)) == sizeof(rec);
+}
+
+void ResponseCurve::setRange(float minDelta, float maxDelta) {
+    m_minDelta = minDelta;
+    m_maxDelta = maxDelta;
+    m_invStep = (LUT_SIZE - 1) / (maxDelta - minDelta);
+}
+
+// ========================================================
+// ======= 校准扫动与拟合 ================================
+// ========================================================
+
+void ResponseCurve::beginSweep() {
+    memset(m_hist, 0, sizeof(m_hist));
+    m_sweepCount = 0;
+    m_sweeping = true;
+}
+
+void ResponseCurve::addSample(float delta) {
+    if (!m_sweeping) return;
+    if (delta < deadZone()) return;  // 无手/死区内，不参与拟合
+
+    int bin = (int)(delta * HIST_BINS / m_cfg.curveHistMaxDelta);
+    bin = constrain(bin, 0, HIST_BINS - 1);
+    if (m_hist[bin] < UINT16_MAX) {
+        m_hist[bin]++;
+        m_sweepCount++;
+    }
+}
+
+bool ResponseCurve::finishSweep() {
+    m_sweeping = false;
+    if (m_sweepCount < (uint32_t)m_cfg.curveMinSamples) return false;
+
+    // 98百分位作为满量程，忽略偶发尖峰
+    uint32_t target = m_sweepCount * 98 / 100;
+    uint32_t acc = 0;
+    int top = HIST_BINS - 1;
+    for (int b = 0; b < HIST_BINS; b++) {
+        acc += m_hist[b];
+        if (acc >= target) {
+            top = b;
+            break;
+        }
+    }
+    float binWidth = m_cfg.curveHistMaxDelta / HIST_BINS;
+    float minDelta = deadZone();
+    float maxDelta = (top + 1) * binWidth;
+    if (!(maxDelta > minDelta)) return false;
+
+    // 直方图CDF (分箱内线性插值) 在各LUT点 (minDelta..maxDelta) 的取值
+    float cdf[LUT_SIZE];
+    int bin = 0;
+    uint32_t below = 0;  // 完整位于当前bin之前的样本数
+    for (int j = 0; j < LUT_SIZE; j++) {
+        float pos = (minDelta + j * (maxDelta - minDelta) / (LUT_SIZE - 1)) / binWidth;
+        while (bin < HIST_BINS && bin + 1 <= pos) {
+            below += m_hist[bin];
+            bin++;
+        }
+        float partial = (bin < HIST_BINS) ? m_hist[bin] * (pos - bin) : 0;
+        cdf[j] = below + partial;
+    }
+
+    // 以死区边界为零点归一化 (边界所在分箱内的部分样本不计入)
+    float span = cdf[LUT_SIZE - 1] - cdf[0];
+    if (!(span > 0)) return false;
+    for (int j = 0; j < LUT_SIZE; j++) {
+        m_table[j] = (uint8_t)constrain(lroundf((cdf[j] - cdf[0]) / span * 255.0f), 0L, 255L);
+    }
+    m_table[LUT_SIZE - 1] = 255;
+    setRange(minDelta, maxDelta);
+    m_valid = true;
+    return true;
+}
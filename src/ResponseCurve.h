@@ -0,0 +1,77 @@
+#ifndef RESPONSE_CURVE_H
+#define RESPONSE_CURVE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+
+// ========================================================
+// ======= ResponseCurve 类 =============================
+// ========================================================
+
+// 按安装环境学习的 delta → 输出 (0..1) 响应曲线
+// - 校准: 手在感应范围内由远到近扫动，记录 delta 直方图
+// - 拟合: 直方图累积分布 (CDF) 作为映射，单调且使扫动范围均匀占满 0-8
+// - 死区: 曲线从 max(deltaFMin, curveNoiseDelta) 开始，低于此值输出0 (与线性映射一致，空闲噪声不动眼睛)
+// - 存储: CURVE_LUT_SIZE 点 uint8 查找表，保存在NVS
+// - 运行: O(1) 线性插值查表
+// 拟合部分不依赖硬件，可在主机上对录制的扫动数据离线运行
+class ResponseCurve {
+public:
+    static const int LUT_SIZE = CURVE_LUT_SIZE;
+    static const int HIST_BINS = CURVE_HIST_BINS;
+
+    // cfg 须在曲线生命周期内有效 (通常为所属引擎的配置)
+    explicit ResponseCurve(const ThereminConfig& cfg) : m_cfg(cfg) {}
+
+    // 从NVS读取已保存的曲线
+    bool begin();
+
+    bool isValid() const { return m_valid; }
+
+    // 每样本O(1)查表，返回 0..1；死区以下为0
+    float map(float delta) const {
+        float pos = (delta - m_minDelta) * m_invStep;
+        if (pos <= 0) return 0.0f;
+        if (pos >= LUT_SIZE - 1) return 1.0f;
+        int i = (int)pos;
+        float frac = pos - i;
+        return (m_table[i] + frac * (m_table[i + 1] - m_table[i])) * (1.0f / 255.0f);
+    }
+
+    // 校准扫动
+    void beginSweep();
+    void addSample(float delta);
+    bool isSweeping() const { return m_sweeping; }
+
+    // 结束扫动并拟合；样本不足时保留原曲线并返回false
+    bool finishSweep();
+
+    // 保存到NVS
+    bool save();
+
+    float getMinDelta() const { return m_minDelta; }
+    float getMaxDelta() const { return m_maxDelta; }
+    const uint8_t* getTable() const { return m_table; }
+
+private:
+    float deadZone() const { return max(m_cfg.deltaFMin, m_cfg.curveNoiseDelta); }
+    void setRange(float minDelta, float maxDelta);
+
+    const ThereminConfig& m_cfg;
+    Preferences m_prefs;
+    bool m_nvsReady = false;
+    bool m_valid = false;
+
+    uint8_t m_table[LUT_SIZE] = {0};
+    float m_minDelta = 0;               // 死区上沿，m_table[0] 对应的 delta
+    float m_maxDelta = 0;
+    float m_invStep = 0;
+
+    // 扫动直方图
+    bool m_sweeping = false;
+    uint16_t m_hist[HIST_BINS] = {0};
+    uint32_t m_sweepCount = 0;
+};
+
+#endif // RESPONSE_CURVE_H
@@ -0,0 +1,117 @@
+#include "ShadowPipeline.h"
+
+bool ShadowPipeline::begin(const ThereminEngine& primary) {
+    m_engine.beginOffline();
+    if (primary.hasWarmSnapshot()) m_engine.armWarmStart(primary.getWarmSnapshot());
+    m_lastRecalibrations = primary.getRecalibrationCount();
+    m_queue = xQueueCreate(config.shadowQueueLen, sizeof(ShadowSample));
+    if (!m_queue) return false;
+    return xTaskCreatePinnedToCore(taskEntry, "ShadowTask", config.shadowTaskStack, this,
+                                   1, &m_task, config.shadowTaskCore) == pdPASS;
+}
+
+void ShadowPipeline::submit(const ThereminEngine& primary, unsigned long now) {
+    if (!m_queue) return;
+
+    ShadowSample sample = capture(primary, now);
+    if (xQueueSend(m_queue, &sample, 0) != pdTRUE) {
+        m_dropped++;
+    }
+}
+
+ShadowSample ShadowPipeline::capture(const ThereminEngine& primary, unsigned long now) {
+    ShadowSample sample;
+    sample.count = primary.getLastInput();
+    sample.timestampMs = now;
+    sample.samplingPeriodMs = (uint16_t)primary.getSamplingPeriodMs();
+    sample.recalibrated = primary.getRecalibrationCount() != m_lastRecalibrations;
+    m_lastRecalibrations = primary.getRecalibrationCount();
+    sample.primaryBaseFreq = primary.getFrozenBaseFreq();
+    sample.primaryLooking = (uint8_t)primary.getLooking();
+    sample.primaryBaselineSet = primary.isBaselineSet();
+    return sample;
+}
+
+// ========================================================
+// ======= 影子任务 (Core 0) =============================
+// ========================================================
+
+void ShadowPipeline::taskEntry(void* arg) {
+    static_cast<ShadowPipeline*>(arg)->taskLoop();
+}
+
+void ShadowPipeline::taskLoop() {
+    ShadowSample sample;
+    unsigned long lastReport = millis();
+
+    while (true) {
+        if (xQueueReceive(m_queue, &sample, pdMS_TO_TICKS(config.shadowReportMs)) == pdTRUE) {
+            processSample(sample);
+        }
+        if (millis() - lastReport >= config.shadowReportMs) {
+            if (!telemetry.isEnabled()) printStats();
+            lastReport = millis();
+        }
+    }
+}
+
+// 与主引擎 process() 的顺序一致: 热启动/滤波 → 按键重校准 → 采样周期切换
+void ShadowPipeline::processSample(const ShadowSample& sample) {
+    EngineOutput out;
+    m_engine.processOffline(sample.count, out, sample.timestampMs);
+    if (sample.recalibrated) m_engine.recalibrate(false);
+    if (sample.samplingPeriodMs) m_engine.setSamplingPeriod(sample.samplingPeriodMs);
+    m_engine.runSpectralAnalysis();
+    compare(sample, out.looking);
+}
+
+// ========================================================
+// ======= 分歧统计 ======================================
+// ========================================================
+
+void ShadowPipeline::compare(const ShadowSample& sample, uint8_t shadowLooking) {
+    unsigned long now = sample.timestampMs;
+
+    // 响应延迟: 配对双方 looking 离开0的时刻，超出窗口未配对则丢弃
+    if (sample.primaryLooking > 0 && m_lastPrimaryLooking == 0) {
+        m_primaryRisen = true;
+        m_primaryRiseMs = now;
+    }
+    if (shadowLooking > 0 && m_lastShadowLooking == 0) {
+        m_shadowRisen = true;
+        m_shadowRiseMs = now;
+    }
+    m_lastPrimaryLooking = sample.primaryLooking;
+    m_lastShadowLooking = shadowLooking;
+
+    if (m_primaryRisen && m_shadowRisen) {
+        m_stats.latencyDiffSumMs += (int32_t)(m_shadowRiseMs - m_primaryRiseMs);
+        m_stats.latencyPairs++;
+        m_primaryRisen = m_shadowRisen = false;
+    }
+    if (m_primaryRisen && now - m_primaryRiseMs > config.shadowLatencyWindowMs) m_primaryRisen = false;
+    if (m_shadowRisen && now - m_shadowRiseMs > config.shadowLatencyWindowMs) m_shadowRisen = false;
+
+    // 输出与基线分歧 (仅在双方基线都已建立后统计)
+    if (!sample.primaryBaselineSet || !m_engine.isBaselineSet()) return;
+
+    m_stats.samples++;
+    int diff = abs((int)shadowLooking - (int)sample.primaryLooking);
+    if (diff) {
+        m_stats.lookingDisagree++;
+        m_stats.lookingAbsDiffSum += diff;
+    }
+    m_stats.baselineDrift = m_engine.getFrozenBaseFreq() - sample.primaryBaseFreq;
+    m_stats.maxBaselineDrift = fmaxf(m_stats.maxBaselineDrift, fabs(m_stats.baselineDrift));
+}
+
+void ShadowPipeline::printStats() const {
+    const DivergenceStats& st = m_stats;
+    float disagreeRate = st.samples ? (float)st.lookingDisagree / st.samples : 0.0f;
+    float meanDiff = st.lookingDisagree ? (float)st.lookingAbsDiffSum / st.lookingDisagree : 0.0f;
+    float latency = st.latencyPairs ? (float)st.latencyDiffSumMs / st.latencyPairs : 0.0f;
+    Serial.printf("SHADOW n:%lu dis:%.3f md:%.2f lat:%.1fms/%lu bd:%.2f bdMax:%.2f drop:%lu\n",
+                  (unsigned long)st.samples, disagreeRate, meanDiff, latency,
+                  (unsigned long)st.latencyPairs, st.baselineDrift, st.maxBaselineDrift,
+                  (unsigned long)m_dropped);
+}
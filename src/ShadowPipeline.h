@@ -0,0 +1,78 @@
+#ifndef SHADOW_PIPELINE_H
+#define SHADOW_PIPELINE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "ThereminEngine.h"
+
+// ========================================================
+// ======= 影子管线 (Shadow A/B Pipeline) ================
+// ========================================================
+
+// 主引擎每个样本的对比快照 (经队列传给影子任务)
+// 除输入外还携带主引擎的运行状态变化 (采样周期、按键重校准)，影子在同一样本处镜像
+struct ShadowSample {
+    float count = 0;                // 折算后的输入计数 (与主引擎输入一致)
+    unsigned long timestampMs = 0;
+    uint16_t samplingPeriodMs = 0;  // 主引擎当前采样周期 (空闲时加长)
+    bool recalibrated = false;      // 主引擎在该样本处执行了基线重校准
+    float primaryBaseFreq = 0;
+    uint8_t primaryLooking = 0;
+    bool primaryBaselineSet = false;
+};
+
+// 分歧统计 (固定内存)
+struct DivergenceStats {
+    uint32_t samples = 0;           // 双方基线均已建立后的对比样本数
+    uint32_t lookingDisagree = 0;   // looking 不一致的样本数
+    uint32_t lookingAbsDiffSum = 0; // |looking差| 累加
+    float baselineDrift = 0;        // 最近的 shadow - primary 冻结基线差 (Hz)
+    float maxBaselineDrift = 0;     // |基线差| 最大值
+    int32_t latencyDiffSumMs = 0;   // 响应延迟差累加 (shadow - primary, 正数表示影子更慢)
+    uint32_t latencyPairs = 0;      // 已配对的响应事件数
+};
+
+// 在第二核上用另一套 ThereminConfig 运行完全独立的滤波/基线管线，
+// 输入与主引擎逐样本相同，只做统计不驱动任何输出
+class ShadowPipeline {
+public:
+    explicit ShadowPipeline(ThereminConfig& cfg) : m_engine(cfg) {}
+
+    // 须在主引擎 begin() 之后调用: 影子沿用主引擎读到的基线快照热启动
+    bool begin(const ThereminEngine& primary);
+
+    // 主循环中每处理一个样本调用一次 (非阻塞)
+    void submit(const ThereminEngine& primary, unsigned long now);
+
+    // 离线对比: 采集主引擎当前样本 (每样本恰好调用一次)，直接在调用者上下文中处理
+    ShadowSample capture(const ThereminEngine& primary, unsigned long now);
+    void processSample(const ShadowSample& sample);
+
+    const ThereminEngine& getEngine() const { return m_engine; }
+    const DivergenceStats& getStats() const { return m_stats; }
+    uint32_t getDroppedCount() const { return m_dropped; }
+    TaskHandle_t getTaskHandle() const { return m_task; }
+    void printStats() const;
+
+private:
+    static void taskEntry(void* arg);
+    void taskLoop();
+    void compare(const ShadowSample& sample, uint8_t shadowLooking);
+
+    ThereminEngine m_engine;
+    QueueHandle_t m_queue = NULL;
+    TaskHandle_t m_task = NULL;
+    DivergenceStats m_stats;               // 仅由影子任务写入
+    volatile uint32_t m_dropped = 0;       // 队列满丢弃的样本 (仅由主循环写入)
+    uint32_t m_lastRecalibrations = 0;     // 已转发的主引擎重校准次数 (仅由主循环写入)
+
+    // 响应延迟配对: 记录各自 looking 离开0的时刻
+    uint8_t m_lastPrimaryLooking = 0;
+    uint8_t m_lastShadowLooking = 0;
+    unsigned long m_primaryRiseMs = 0;
+    unsigned long m_shadowRiseMs = 0;
+    bool m_primaryRisen = false;
+    bool m_shadowRisen = false;
+};
+
+#endif // SHADOW_PIPELINE_H
@@ -0,0 +1,180 @@
+#include "SpectralAnalyzer.h"
+
+// ========================================================
+// ======= NotchFilter ===================================
+// ========================================================
+
+void NotchFilter::configure(float centerHz, float sampleRateHz, float q) {
+    float w0 = 2.0f * (float)M_PI * centerHz / sampleRateHz;
+    float cosW0 = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+
+    m_b0 = 1.0f / a0;
+    m_b1 = -2.0f * cosW0 / a0;
+    m_b2 = 1.0f / a0;
+    m_a1 = -2.0f * cosW0 / a0;
+    m_a2 = (1.0f - alpha) / a0;
+    m_centerHz = centerHz;
+}
+
+void NotchFilter::prime(float x) {
+    // 直流稳态: y = x
+    m_z2 = (m_b2 - m_a2) * x;
+    m_z1 = (m_b1 - m_a1) * x + m_z2;
+}
+
+// ========================================================
+// ======= SpectralAnalyzer ==============================
+// ========================================================
+
+bool SpectralAnalyzer::begin() {
+    for (int i = 0; i < FFT_SIZE; i++) {
+        m_window[i] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / (FFT_SIZE - 1));
+    }
+#if SPECTRUM_USE_ESP_DSP
+    if (dsps_fft2r_init_fc32(NULL, FFT_SIZE) != ESP_OK) return false;
+#else
+    for (int k = 0; k < FFT_SIZE / 2; k++) {
+        float angle = 2.0f * (float)M_PI * k / FFT_SIZE;
+        m_twiddle[2 * k] = cosf(angle);
+        m_twiddle[2 * k + 1] = -sinf(angle);
+    }
+#endif
+    reset();
+    return true;
+}
+
+void SpectralAnalyzer::push(float rawFreq) {
+    m_history[m_head] = rawFreq;
+    m_head = (m_head + 1) % FFT_SIZE;
+    if (m_filled < FFT_SIZE) m_filled++;
+    m_sinceFrame++;
+}
+
+void SpectralAnalyzer::reset() {
+    resetHistory();
+    resetPeaks();
+}
+
+void SpectralAnalyzer::resetHistory() {
+    m_head = 0;
+    m_filled = 0;
+    m_sinceFrame = 0;
+}
+
+void SpectralAnalyzer::resetPeaks() {
+    memset(m_peakHits, 0, sizeof(m_peakHits));
+}
+
+void SpectralAnalyzer::copyFrame(float* frame) {
+    m_sinceFrame = 0;
+    for (int i = 0; i < FFT_SIZE; i++) {
+        frame[i] = m_history[(m_head + i) % FFT_SIZE];
+    }
+}
+
+int SpectralAnalyzer::analyze(float sampleRateHz, float* peaksHz, int maxPeaks) {
+    copyFrame(m_frame);
+    return analyzeFrame(m_frame, sampleRateHz, peaksHz, maxPeaks);
+}
+
+int SpectralAnalyzer::analyzeFrame(const float* frame, float sampleRateHz, float* peaksHz, int maxPeaks) {
+    m_frames++;
+
+    // 去均值 + 加窗
+    float mean = 0;
+    for (int i = 0; i < FFT_SIZE; i++) mean += frame[i];
+    mean /= FFT_SIZE;
+    for (int i = 0; i < FFT_SIZE; i++) {
+        m_work[2 * i] = (frame[i] - mean) * m_window[i];
+        m_work[2 * i + 1] = 0;
+    }
+
+    uint32_t t0 = micros();
+    fft(m_work);
+    m_lastFftUs = micros() - t0;
+    m_maxFftUs = max(m_maxFftUs, m_lastFftUs);
+
+    // 功率谱 (跳过直流)
+    float total = 0;
+    m_power[0] = 0;
+    for (int k = 1; k < BIN_COUNT; k++) {
+        float re = m_work[2 * k], im = m_work[2 * k + 1];
+        m_power[k] = re * re + im * im;
+        total += m_power[k];
+    }
+    float threshold = total / (BIN_COUNT - 1) * m_cfg.spectrumPeakRatio;
+
+    // 峰值持续性：命中累加，未命中衰减；低于 spectrumMinHz 的频段属于手部运动
+    int minBin = max(1, (int)ceilf(m_cfg.spectrumMinHz * FFT_SIZE / sampleRateHz));
+    int hitsCap = m_cfg.spectrumStableFrames * 2;
+    int count = 0;
+    float peakPower[NOTCH_MAX];
+    for (int k = minBin; k < BIN_COUNT; k++) {
+        bool localMax = m_power[k] >= m_power[k - 1] &&
+                        (k == BIN_COUNT - 1 || m_power[k] >= m_power[k + 1]);
+        if (localMax && m_power[k] > threshold) {
+            m_peakHits[k] = min(m_peakHits[k] + 1, hitsCap);
+        } else if (m_peakHits[k] > 0) {
+            m_peakHits[k]--;
+        }
+        if (m_peakHits[k] < m_cfg.spectrumStableFrames) continue;
+
+        // 按功率降序插入
+        int pos = count < maxPeaks ? count++ : maxPeaks;
+        while (pos > 0 && peakPower[pos - 1] < m_power[k]) {
+            if (pos < maxPeaks) {
+                peakPower[pos] = peakPower[pos - 1];
+                peaksHz[pos] = peaksHz[pos - 1];
+            }
+            pos--;
+        }
+        if (pos < maxPeaks) {
+            peakPower[pos] = m_power[k];
+            peaksHz[pos] = k * sampleRateHz / FFT_SIZE;
+        }
+    }
+    return count;
+}
+
+void SpectralAnalyzer::fft(float* data) {
+#if SPECTRUM_USE_ESP_DSP
+    dsps_fft2r_fc32(data, FFT_SIZE);
+    dsps_bit_rev_fc32(data, FFT_SIZE);
+#else
+    // 位反转重排
+    for (int i = 1, j = 0; i < FFT_SIZE; i++) {
+        int bit = FFT_SIZE >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            float tr = data[2 * i], ti = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = tr;
+            data[2 * j + 1] = ti;
+        }
+    }
+
+    // 蝶形运算
+    for (int len = 2; len <= FFT_SIZE; len <<= 1) {
+        int half = len / 2;
+        int step = FFT_SIZE / len;
+        for (int i = 0; i < FFT_SIZE; i += len) {
+            for (int k = 0; k < half; k++) {
+                float wr = m_twiddle[2 * k * step];
+                float wi = m_twiddle[2 * k * step + 1];
+                int a = 2 * (i + k);
+                int b = 2 * (i + k + half);
+                float tr = data[b] * wr - data[b + 1] * wi;
+                float ti = data[b] * wi + data[b + 1] * wr;
+                data[b] = data[a] - tr;
+                data[b + 1] = data[a + 1] - ti;
+                data[a] += tr;
+                data[a + 1] += ti;
+            }
+        }
+    }
+#endif
+}
@@ -0,0 +1,107 @@
+#ifndef SPECTRAL_ANALYZER_H
+#define SPECTRAL_ANALYZER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#if __has_include(<esp_dsp.h>)
+#include <esp_dsp.h>
+#define SPECTRUM_USE_ESP_DSP 1
+#else
+#define SPECTRUM_USE_ESP_DSP 0
+#endif
+
+// ========================================================
+// ======= 二阶IIR陷波器 (RBJ Biquad Notch) ==============
+// ========================================================
+
+// 直接II型转置；直流增益为1，不影响基线
+class NotchFilter {
+public:
+    void configure(float centerHz, float sampleRateHz, float q);
+
+    // 以当前输入为直流稳态初始化，避免切换时的瞬态
+    void prime(float x);
+
+    float process(float x) {
+        float y = m_b0 * x + m_z1;
+        m_z1 = m_b1 * x - m_a1 * y + m_z2;
+        m_z2 = m_b2 * x - m_a2 * y;
+        return y;
+    }
+
+    float getCenterHz() const { return m_centerHz; }
+
+private:
+    float m_b0 = 1, m_b1 = 0, m_b2 = 0, m_a1 = 0, m_a2 = 0;
+    float m_z1 = 0, m_z2 = 0;
+    float m_centerHz = 0;
+};
+
+// ========================================================
+// ======= SpectralAnalyzer 类 ==========================
+// ========================================================
+
+// 原始计数历史的加窗FFT (汉宁窗, 50%重叠)，识别持续存在的干扰峰
+// - 设备端: 可用时使用 esp-dsp (S3 向量指令)
+// - 其他: 可移植的 radix-2 内核
+// 采集端 (push/copyFrame/resetHistory) 与分析端 (analyzeFrame/resetPeaks) 不共享状态，
+// 可分别在采样路径与后台分析任务中调用；帧的交接由调用方加锁
+class SpectralAnalyzer {
+public:
+    static const int FFT_SIZE = SPECTRUM_FFT_SIZE;
+    static const int BIN_COUNT = FFT_SIZE / 2;
+
+    // cfg 须在分析器生命周期内有效；默认使用全局配置
+    explicit SpectralAnalyzer(const ThereminConfig& cfg = config) : m_cfg(cfg) {}
+
+    bool begin();
+
+    // 每样本O(1)入队
+    void push(float rawFreq);
+
+    // 丢弃历史与峰值持续性统计 (单任务使用时)
+    void reset();
+    // 采集端: 丢弃历史 (采样率变化时调用)
+    void resetHistory();
+    // 分析端: 丢弃峰值持续性统计
+    void resetPeaks();
+
+    bool frameReady() const { return m_filled >= FFT_SIZE && m_sinceFrame >= FFT_SIZE / 2; }
+
+    // 采集端: 按时间顺序取出当前一帧 (FFT_SIZE 个样本) 并开始累计下一帧
+    void copyFrame(float* frame);
+
+    // 分析端: 分析一帧；返回稳定干扰峰数量，频率 (Hz) 写入 peaksHz (按功率降序)
+    int analyzeFrame(const float* frame, float sampleRateHz, float* peaksHz, int maxPeaks);
+
+    // 单任务使用: copyFrame + analyzeFrame
+    int analyze(float sampleRateHz, float* peaksHz, int maxPeaks);
+
+    uint32_t getFrameCount() const { return m_frames; }
+    uint32_t getLastFftMicros() const { return m_lastFftUs; }
+    uint32_t getMaxFftMicros() const { return m_maxFftUs; }
+
+private:
+    void fft(float* data);
+
+    const ThereminConfig& m_cfg;
+    float m_history[FFT_SIZE] = {0};   // 环形缓冲
+    float m_frame[FFT_SIZE];           // analyze() 的帧副本
+    float m_work[FFT_SIZE * 2];        // 交错复数 re/im
+    float m_window[FFT_SIZE];
+    float m_power[BIN_COUNT];
+    uint8_t m_peakHits[BIN_COUNT] = {0};
+#if !SPECTRUM_USE_ESP_DSP
+    float m_twiddle[FFT_SIZE];         // cos/sin 交错, FFT_SIZE/2 组
+#endif
+
+    int m_head = 0;
+    int m_filled = 0;
+    int m_sinceFrame = 0;
+    uint32_t m_frames = 0;
+    uint32_t m_lastFftUs = 0;
+    uint32_t m_maxFftUs = 0;
+};
+
+#endif // SPECTRAL_ANALYZER_H
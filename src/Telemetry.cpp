@@ -0,0 +1,106 @@
+#include "Telemetry.h"
+
+Telemetry telemetry;
+
+#define FRAME_TYPE_SAMPLE   0x01
+#define FRAME_HEADER_SIZE   11      // 类型 + 序号 + 时间戳 + 掩码
+#define FRAME_MAX_RAW       (FRAME_HEADER_SIZE + TF_COUNT * 4 + 2)
+#define FRAME_MAX_ENCODED   (FRAME_MAX_RAW + FRAME_MAX_RAW / 254 + 2)
+
+// ========================================================
+// ======= 编码工具 ======================================
+// ========================================================
+
+static uint16_t crc16Ccitt(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+// COBS编码，输出末尾追加 0x00 分隔符；返回编码后长度
+static size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t write = 1;
+    size_t codePos = 0;
+    uint8_t code = 1;
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[codePos] = code;
+            codePos = write++;
+            code = 1;
+            continue;
+        }
+        out[write++] = in[i];
+        if (++code == 0xFF) {
+            out[codePos] = code;
+            codePos = write++;
+            code = 1;
+        }
+    }
+    out[codePos] = code;
+    out[write++] = 0x00;
+    return write;
+}
+
+static inline void putU16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+static inline void putU32(uint8_t* p, uint32_t v) { p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+
+// ========================================================
+// ======= Telemetry =====================================
+// ========================================================
+
+bool Telemetry::begin() {
+    m_fieldMask = config.telemetryDefaultFields;
+    m_stream = xStreamBufferCreate(config.telemetryBufferSize, 1);
+    if (!m_stream) return false;
+    return xTaskCreatePinnedToCore(taskEntry, "TelemetryTask", config.telemetryTaskStack, this,
+                                   1, &m_task, config.telemetryTaskCore) == pdPASS;
+}
+
+// 单生产者：只能在主循环 (process) 中调用
+void Telemetry::publish(unsigned long timestampMs, const float* values) {
+    uint32_t mask = m_fieldMask;
+    if (!m_stream || !mask) return;
+
+    uint8_t raw[FRAME_MAX_RAW];
+    raw[0] = FRAME_TYPE_SAMPLE;
+    putU16(raw + 1, m_seq++);
+    putU32(raw + 3, timestampMs);
+    putU32(raw + 7, mask);
+    size_t len = FRAME_HEADER_SIZE;
+    for (int f = 0; f < TF_COUNT; f++) {
+        if (mask & TF_BIT(f)) {
+            memcpy(raw + len, &values[f], 4);
+            len += 4;
+        }
+    }
+    putU16(raw + len, crc16Ccitt(raw, len));
+    len += 2;
+
+    uint8_t encoded[FRAME_MAX_ENCODED];
+    size_t encodedLen = cobsEncode(raw, len, encoded);
+
+    // 整帧写入或整帧丢弃，保证输出流中不出现半帧
+    if (xStreamBufferSpacesAvailable(m_stream) < encodedLen) {
+        m_dropped++;
+        return;
+    }
+    xStreamBufferSend(m_stream, encoded, encodedLen, 0);
+    m_sent++;
+}
+
+void Telemetry::taskEntry(void* arg) {
+    static_cast<Telemetry*>(arg)->taskLoop();
+}
+
+void Telemetry::taskLoop() {
+    uint8_t chunk[128];
+    while (true) {
+        size_t n = xStreamBufferReceive(m_stream, chunk, sizeof(chunk), portMAX_DELAY);
+        if (n) Serial.write(chunk, n);
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "freertos/stream_buffer.h"
+#include "config.h"
+
+// ========================================================
+// ======= 遥测字段 (Telemetry Fields) ===================
+// ========================================================
+// 位序即帧内字段顺序，须与 tools/telemetry_decode.py 保持一致
+
+enum TelemetryField : uint8_t {
+    TF_RAW_COUNT = 0,       // 折算后的输入计数
+    TF_SMOOTHED_FREQ,
+    TF_SMOOTHED_BASE,
+    TF_FROZEN_BASE,
+    TF_DELTA_RAW,           // frozenBaseFreq - smoothedFreq
+    TF_DELTA,
+    TF_SMOOTHED_DELTA,
+    TF_DELTA_RATE,
+    TF_LOOKING,             // 平滑后的 looking (浮点)
+    TF_DUTY,
+    TF_DIRECTION,
+    TF_ENV_COUNT,
+    TF_ENV_STABLE_COUNTER,
+    TF_ENV_JITTER,
+    TF_STATIC_COUNT,
+    TF_STABLE_COUNT,
+    TF_BASE_ALPHA,
+    TF_ENV_FACTOR,
+    TF_HAND_FACTOR,
+    TF_ADAPTIVE_ALPHA,
+    TF_NOTCH_COUNT,
+    TF_IDLE,
+    TF_DROPPED,             // 遥测累计丢帧数
+    TF_COUNT
+};
+
+#define TF_BIT(f)  (1UL << (f))
+
+// 预设字段组合 (取代原 DEBUG_MODE_* 编译期开关，可任意组合)
+#define TELEMETRY_PRESET_ALPHA   (TF_BIT(TF_DELTA_RAW) | TF_BIT(TF_ENV_STABLE_COUNTER) | \
+                                  TF_BIT(TF_STATIC_COUNT) | TF_BIT(TF_BASE_ALPHA) | \
+                                  TF_BIT(TF_ENV_FACTOR) | TF_BIT(TF_HAND_FACTOR) | \
+                                  TF_BIT(TF_ADAPTIVE_ALPHA))
+#define TELEMETRY_PRESET_PLOTTER (TF_BIT(TF_SMOOTHED_FREQ) | TF_BIT(TF_SMOOTHED_BASE) | \
+                                  TF_BIT(TF_DELTA) | TF_BIT(TF_DELTA_RATE))
+#define TELEMETRY_PRESET_SIMPLE  (TF_BIT(TF_SMOOTHED_FREQ) | TF_BIT(TF_SMOOTHED_BASE) | \
+                                  TF_BIT(TF_DELTA) | TF_BIT(TF_LOOKING))
+
+// ========================================================
+// ======= Telemetry 类 =================================
+// ========================================================
+
+// 帧格式 (小端):
+//   u8 类型 (0x01 = 样本) | u16 序号 | u32 时间戳ms | u32 字段掩码 |
+//   f32 × popcount(掩码) (按位序) | u16 CRC-16/CCITT-FALSE
+// 整帧经 COBS 编码后以 0x00 结尾
+// 采样路径只做编码并写入流缓冲；低优先级任务负责串口输出，缓冲满时整帧丢弃并计数
+class Telemetry {
+public:
+    bool begin();
+
+    void setFieldMask(uint32_t mask) { m_fieldMask = mask & ((1UL << TF_COUNT) - 1); }
+    uint32_t getFieldMask() const { return m_fieldMask; }
+    bool isEnabled() const { return m_stream && m_fieldMask; }
+
+    // values 按 TelemetryField 索引，长度 TF_COUNT
+    void publish(unsigned long timestampMs, const float* values);
+
+    uint32_t getDroppedCount() const { return m_dropped; }
+    uint32_t getSentCount() const { return m_sent; }
+    TaskHandle_t getTaskHandle() const { return m_task; }
+
+private:
+    static void taskEntry(void* arg);
+    void taskLoop();
+
+    StreamBufferHandle_t m_stream = NULL;
+    TaskHandle_t m_task = NULL;
+    volatile uint32_t m_fieldMask = 0;
+    uint16_t m_seq = 0;
+    uint32_t m_sent = 0;
+    uint32_t m_dropped = 0;
+};
+
+// 全局遥测实例
+extern Telemetry telemetry;
+
+#endif // TELEMETRY_H
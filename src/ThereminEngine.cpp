@@ -33,8 +33,13 @@ void IRAM_ATTR ThereminEngine::onButtonISR() {
 // ======= 构造函数与初始化 ==============================
 // ========================================================
 
-ThereminEngine::ThereminEngine() 
-    : m_pcntUnit(nullptr)
+ThereminEngine::ThereminEngine(ThereminConfig& cfg) 
+    : m_cfg(cfg)
+    , m_store(cfg)
+    , m_spectrum(cfg)
+    , m_curve(cfg)
+    , m_quant(cfg)
+    , m_pcntUnit(nullptr)
     , m_pcntChannel(nullptr)
     , m_timer(nullptr)
     , m_pulseCount(0)
@@ -42,14 +47,17 @@ ThereminEngine::ThereminEngine()
     , m_dataReady(false)
     , m_duty(0)
     , m_delta(0)
+    , m_samplingPeriodMs(cfg.samplingPeriodMs)
 {
     m_timerMux = portMUX_INITIALIZER_UNLOCKED;
     m_baselineMux = portMUX_INITIALIZER_UNLOCKED;
+    m_spectrumMux = portMUX_INITIALIZER_UNLOCKED;
 }
 
 bool ThereminEngine::begin() {
     // 设置ISR回调实例指针 (必须在其他初始化之前)
     s_engineInstance = this;
+    m_samplingPeriodMs = m_cfg.samplingPeriodMs;
     
     // 初始化硬件
     if (!setupPCNT()) {
@@ -69,24 +77,66 @@ bool ThereminEngine::begin() {
     
     setupButton();
     
+    if (m_cfg.enableSpectralNotch && !m_spectrum.begin()) {
+        Serial.println("WARN: FFT init failed, notch disabled");
+        m_cfg.enableSpectralNotch = false;
+    }
+    // 任务创建失败时仍可工作: 由主循环调用 runSpectralAnalysis()
+    if (m_cfg.enableSpectralNotch) {
+        xTaskCreatePinnedToCore(spectrumTaskEntry, "SpectrumTask", m_cfg.spectrumTaskStack, this,
+                                1, &m_spectrumTask, m_cfg.spectrumTaskCore);
+    }
+    
+    if (m_cfg.enableResponseCurve && m_curve.begin()) {
+        Serial.printf("Response curve loaded (max delta %.1f)\n", m_curve.getMaxDelta());
+    }
+    
+    // 读取基线快照 (NVS不可用时仍可使用RTC快照)
+    warmState.bootTime = millis();
+    if (!m_store.begin()) {
+        Serial.println("WARN: NVS unavailable, baseline snapshot RTC only");
+    }
+    if (m_cfg.warmStartEnable && m_store.load(warmState.snapshot)) {
+        warmState.pending = true;
+        Serial.printf("Baseline snapshot found: %.1f\n", warmState.snapshot.frozenBaseFreq);
+    }
+    
     Serial.println("Theremin Engine Started");
     return true;
 }
 
+// 离线/影子实例：仅初始化纯计算部分 (FFT、响应曲线)，不占用任何硬件
+bool ThereminEngine::beginOffline() {
+    m_samplingPeriodMs = m_cfg.samplingPeriodMs;
+    if (m_cfg.enableSpectralNotch && !m_spectrum.begin()) {
+        m_cfg.enableSpectralNotch = false;
+    }
+    if (m_cfg.enableResponseCurve) {
+        m_curve.begin();
+    }
+    return true;
+}
+
 // ========================================================
 // ======= 硬件初始化函数 ================================
 // ========================================================
 
+// 设计输入频率上限下，正常/空闲采样周期内的计数都必须在PCNT范围内
+static_assert((long long)PCNT_MAX_INPUT_HZ * SAMPLING_PERIOD_MS / 1000 <= PCNT_COUNT_LIMIT,
+              "SAMPLING_PERIOD_MS too long: PCNT overflows at PCNT_MAX_INPUT_HZ");
+static_assert((long long)PCNT_MAX_INPUT_HZ * IDLE_SAMPLING_PERIOD_MS / 1000 <= PCNT_COUNT_LIMIT,
+              "IDLE_SAMPLING_PERIOD_MS too long: PCNT overflows at PCNT_MAX_INPUT_HZ");
+
 bool ThereminEngine::setupPCNT() {
-    pinMode(config.pcntPin, INPUT);
+    pinMode(m_cfg.pcntPin, INPUT);
     
-    pcnt_unit_config_t uc = {.low_limit = -32767, .high_limit = 32767};
+    pcnt_unit_config_t uc = {.low_limit = -m_cfg.pcntCountLimit, .high_limit = m_cfg.pcntCountLimit};
     if (pcnt_new_unit(&uc, &m_pcntUnit) != ESP_OK) return false;
     
     pcnt_glitch_filter_config_t gf = {.max_glitch_ns = 100};
     if (pcnt_unit_set_glitch_filter(m_pcntUnit, &gf) != ESP_OK) return false;
     
-    pcnt_chan_config_t cc = {.edge_gpio_num = config.pcntPin, .level_gpio_num = -1};
+    pcnt_chan_config_t cc = {.edge_gpio_num = m_cfg.pcntPin, .level_gpio_num = -1};
     if (pcnt_new_channel(m_pcntUnit, &cc, &m_pcntChannel) != ESP_OK) return false;
     
     pcnt_channel_set_edge_action(m_pcntChannel,
@@ -104,59 +154,211 @@ bool ThereminEngine::setupTimer() {
     m_timer = timerBegin(1000000);
     if (!m_timer) return false;
     timerAttachInterrupt(m_timer, &onTimerISR);
-    timerAlarm(m_timer, config.samplingPeriodMs * 1000, true, 0);
+    timerAlarm(m_timer, m_samplingPeriodMs * 1000, true, 0);
     timerStart(m_timer);
     return true;
 }
 
 bool ThereminEngine::setupPWM() {
-    ledcAttach(config.pwmPin, 1000, 8);
-    ledcWrite(config.pwmPin, 0);
+    ledcAttach(m_cfg.pwmPin, 1000, 8);
+    ledcWrite(m_cfg.pwmPin, 0);
     return true;
 }
 
 void ThereminEngine::setupButton() {
-    pinMode(config.buttonPin, INPUT_PULLUP);
-    attachInterrupt(config.buttonPin, &onButtonISR, FALLING);
+    pinMode(m_cfg.buttonPin, INPUT_PULLUP);
+    attachInterrupt(m_cfg.buttonPin, &onButtonISR, FALLING);
 }
 
 // ========================================================
 // ======= 核心处理函数 ================================
 // ========================================================
 
-void ThereminEngine::process() {
+bool ThereminEngine::process() {
     // ===== 频率采集 =====
-    int currentFreq;
+    int pulseCount;
     portENTER_CRITICAL(&m_timerMux);
     if (m_dataReady) {
-        currentFreq = m_pulseCount;
+        pulseCount = m_pulseCount;
         m_dataReady = false;
     } else {
         portEXIT_CRITICAL(&m_timerMux);
-        return;
+        return false;
     }
     portEXIT_CRITICAL(&m_timerMux);
     
+    // 空闲时采样周期加长，按比例折算回正常周期的计数，保持基线单位一致
+    float currentFreq = (float)pulseCount * m_cfg.samplingPeriodMs / m_samplingPeriodMs;
+    m_lastInput = currentFreq;
+    
+    // ===== 热启动恢复 =====
+    // 先记录基线状态：热启动与冷启动两条路径都要经过 markBaselineValid
+    bool baselineWasSet = freqState.baselineSet;
+    tryWarmStart(currentFreq);
+    
+    // ===== 滤波计算 (单样本块) =====
+    EngineOutput out;
+    processBlock(&currentFreq, &out, 1, millis());
+    if (!baselineWasSet && freqState.baselineSet) {
+        markBaselineValid();
+    }
+    
+    // ===== PWM输出 =====
+    ledcWrite(m_cfg.pwmPin, m_duty);
+    
+    // ===== 按键校准 =====
+    bool buttonActivity = handleButton();
+    if (m_curve.isSweeping()) {
+        updateCurveCalibration();
+    }
+    
+    // ===== 基线快照 =====
+    saveSnapshot();
+    
+    // ===== 空闲状态机 =====
+    if (m_cfg.idlePowerEnable) {
+        updateIdleState(buttonActivity);
+    }
+    
+    // ===== 遥测输出 =====
+    publishTelemetry();
+    return true;
+}
+
+void ThereminEngine::processOffline(float count, EngineOutput& out, unsigned long now) {
+    m_lastInput = count;
+    tryWarmStart(count);
+    processBlock(&count, &out, 1, now);
+}
+
+// ========================================================
+// ======= 块处理 (Block Processing) =====================
+// ========================================================
+
+// 纯计算路径：无硬件访问，可用于实时采样、回放与离线调参
+// 每块分阶段执行，无跨样本依赖的阶段写成独立的连续数组循环 (循环体小、状态读写集中)；
+// Xtensa GCC 未验证对这些浮点循环做自动向量化，块/逐样本的耗时对比见 test/test_process_block：
+//   1. 陷波 + 频谱入队      (IIR递推, 逐样本)
+//   2. deltaRate 差分       (无依赖)
+//   3. 频率/delta滤波与基线 (EMA递推, 逐样本)
+//   4. looking/duty 映射    (无依赖)
+//   5. 输出平滑             (EMA递推, 逐样本)
+//   6. 输出量化             (滞回/驻留/限速, 逐样本)
+size_t ThereminEngine::processBlock(const float* counts, EngineOutput* out, size_t count,
+                                    unsigned long firstSampleMs) {
+    float freq[BLOCK_MAX_SAMPLES];
+    float rate[BLOCK_MAX_SAMPLES];
+    float smoothedDelta[BLOCK_MAX_SAMPLES];
+    int looking[BLOCK_MAX_SAMPLES];
+    float smoothLooking[BLOCK_MAX_SAMPLES];
+    int duty[BLOCK_MAX_SAMPLES];
+    bool jitter[BLOCK_MAX_SAMPLES];
+    
+    // Arduino map() 语义: 参数先截断为整数
+    const long inMin = (long)(m_cfg.deltaFMin * 10);
+    const long inRun = (long)(m_cfg.deltaFMax * 10) - inMin;
+    
+    for (size_t done = 0; done < count; ) {
+        size_t n = min(count - done, (size_t)BLOCK_MAX_SAMPLES);
+        const float* in = counts + done;
+        EngineOutput* o = out + done;
+        
+        // ===== 1. 干扰陷波 =====
+        if (m_cfg.enableSpectralNotch) {
+            takeNotchDesign();
+            for (size_t i = 0; i < n; i++) {
+                m_spectrum.push(in[i]);
+                if (m_spectrum.frameReady()) queueSpectrumFrame();
+                freq[i] = applyNotches(in[i]);
+            }
+        } else {
+            memcpy(freq, in, n * sizeof(float));
+        }
+        
+        // ===== 2. 频率变化率 =====
+        rate[0] = freq[0] - freqState.lastRawFreq;
+        for (size_t i = 1; i < n; i++) {
+            rate[i] = freq[i] - freq[i - 1];
+        }
+        freqState.lastRawFreq = freq[n - 1];
+        
+        // ===== 3. 滤波与基线 =====
+        for (size_t i = 0; i < n; i++) {
+            m_now = firstSampleMs + (done + i) * m_samplingPeriodMs;
+            freqState.deltaRate = rate[i];
+            processFilters(freq[i]);
+            smoothedDelta[i] = freqState.lastSmoothedDelta;
+            jitter[i] = envState.isEnvironmentalJitter;
+            o[i].delta = m_delta;
+            o[i].smoothedDelta = freqState.lastSmoothedDelta;
+            o[i].direction = (int8_t)stabState.direction;
+        }
+        
+        // ===== 4. 眼睛/PWM映射 (学习曲线查表 / 线性) =====
+        if (m_cfg.enableResponseCurve && m_curve.isValid()) {
+            for (size_t i = 0; i < n; i++) {
+                float v = m_curve.map(smoothedDelta[i]);
+                looking[i] = (int)(v * 8);
+                duty[i] = (int)(v * 255);
+            }
+        } else if (inRun > 0) {
+            for (size_t i = 0; i < n; i++) {
+                long x = (long)(smoothedDelta[i] * 10) - inMin;
+                looking[i] = constrain((int)(x * 8 / inRun), 0, 8);
+                duty[i] = constrain((int)(x * 255 / inRun), 0, 255);
+            }
+        } else {
+            // deltaFMax <= deltaFMin: 映射区间为空，按 inMin 处的阶跃处理 (避免整数除零)
+            for (size_t i = 0; i < n; i++) {
+                bool on = (long)(smoothedDelta[i] * 10) > inMin;
+                looking[i] = on ? 8 : 0;
+                duty[i] = on ? 255 : 0;
+            }
+        }
+        
+        // ===== 5. 输出平滑滤波 (EMA) =====
+        float lookAlpha = 0.2f;  // 输出平滑系数
+        for (size_t i = 0; i < n; i++) {
+            int prevLooking = (int)stabState.smoothedLooking;
+            stabState.smoothedLooking = lookAlpha * looking[i] + (1 - lookAlpha) * stabState.smoothedLooking;
+            if (jitter[i] && (int)stabState.smoothedLooking != prevLooking) {
+                envState.jitterLookingChanges++;
+            }
+            smoothLooking[i] = stabState.smoothedLooking;
+        }
+        
+        // ===== 6. 输出量化 =====
+        for (size_t i = 0; i < n; i++) {
+            m_quant.update(firstSampleMs + (done + i) * m_samplingPeriodMs,
+                           smoothLooking[i], duty[i]);
+            o[i].looking = (uint8_t)m_quant.getLooking();
+            o[i].duty = (uint8_t)m_quant.getDuty();
+        }
+        stabState.looking = looking[n - 1];
+        m_duty = m_quant.getDuty();
+        
+        done += n;
+    }
+    return count;
+}
+
+// 单样本滤波递推 (调用前已设置 deltaRate 与 m_now)
+void ThereminEngine::processFilters(float currentFreq) {
     // ===== 频率滤波 =====
     freqState.smoothedFreq = filterFrequency(currentFreq, freqState.smoothedFreq);
-    freqState.deltaRate = currentFreq - freqState.lastRawFreq;
-    freqState.lastRawFreq = currentFreq;
     
     // ===== 基线初始化 =====
     initBaseline(freqState.smoothedFreq);
     
     // ===== 计算Delta =====
     float deltaRaw = freqState.frozenBaseFreq - freqState.smoothedFreq;
-    stabState.direction = (deltaRaw > config.directionThreshold) ? -1 : 
-                         (deltaRaw < -config.directionThreshold) ? 1 : 0;
+    stabState.direction = (deltaRaw > m_cfg.directionThreshold) ? -1 : 
+                         (deltaRaw < -m_cfg.directionThreshold) ? 1 : 0;
     m_delta = fabs(deltaRaw);
     
     // ===== Delta滤波 =====
     freqState.lastSmoothedDelta = filterDelta(m_delta, freqState.lastSmoothedDelta);
     
-    // ===== PWM输出 =====
-    updatePWM();
-    
     // ===== 稳定性判断 =====
     updateStability(m_delta);
     
@@ -169,38 +371,24 @@ void ThereminEngine::process() {
     staticState.lastDeltaRaw = deltaRaw;
     
     // ===== 自适应基线更新 =====
-    if (config.autoSetBase) {
+    if (m_cfg.autoSetBase) {
         updateAdaptiveBaseline(m_delta, deltaRaw);
     }
-    
-    // ===== 手动校准 =====
-    recalibrate();
-    
-    // ===== 眼睛映射 =====
-    stabState.looking = map(freqState.lastSmoothedDelta * 10, 
-                           config.deltaFMin * 10, config.deltaFMax * 10, 0, 8);
-    stabState.looking = constrain(stabState.looking, 0, 8);
-    // 输出平滑滤波 (EMA)
-    float lookAlpha = 0.2f;  // 输出平滑系数
-    stabState.smoothedLooking = lookAlpha * stabState.looking + (1 - lookAlpha) * stabState.smoothedLooking;
-    
-    // ===== 调试输出 =====
-    debugOutput();
 }
 
 // 频率EMA滤波
 float ThereminEngine::filterFrequency(float currentFreq, float smoothedFreq) {
     float diff = fabs(currentFreq - smoothedFreq);
-    float alpha = diff > config.freqThresholdSpike ? config.alphaFreqSpike :
-                  diff > config.freqThresholdMedium ? 
-                      min(config.alphaFreqBase + diff * config.alphaFreqDynamic, config.alphaFreqMax) :
-                      config.alphaFreqSmall;
+    float alpha = diff > m_cfg.freqThresholdSpike ? m_cfg.alphaFreqSpike :
+                  diff > m_cfg.freqThresholdMedium ? 
+                      min(m_cfg.alphaFreqBase + diff * m_cfg.alphaFreqDynamic, m_cfg.alphaFreqMax) :
+                      m_cfg.alphaFreqSmall;
     return alpha * currentFreq + (1 - alpha) * smoothedFreq;
 }
 
 // Delta EMA滤波
 float ThereminEngine::filterDelta(float delta, float lastSmoothedDelta) {
-    float alphaD = min(config.alphaDeltaBase + delta * config.alphaDeltaDynamic, config.alphaDeltaMax);
+    float alphaD = min(m_cfg.alphaDeltaBase + delta * m_cfg.alphaDeltaDynamic, m_cfg.alphaDeltaMax);
     return alphaD * delta + (1 - alphaD) * lastSmoothedDelta;
 }
 
@@ -211,11 +399,11 @@ void ThereminEngine::updateStability(float delta) {
         return;
     }
     
-    if (fabs(delta - freqState.lastStableDelta) <= config.stabilityThreshold) {
+    if (fabs(delta - freqState.lastStableDelta) <= m_cfg.stabilityThreshold) {
         freqState.stableCount++;
-        if (freqState.stableCount >= config.stableWindow) {
+        if (freqState.stableCount >= m_cfg.stableWindow) {
             freqState.lastStableDelta = delta;
-            freqState.stableCount = config.stableWindow;
+            freqState.stableCount = m_cfg.stableWindow;
         }
     } else {
         freqState.stableCount = 0;
@@ -228,21 +416,21 @@ void ThereminEngine::updateStability(float delta) {
 // - 手移动 = 频率大幅单向变化
 // 当 deltaRate 很大时（手移动），清除环境检测状态
 void ThereminEngine::detectEnvironmentJitter(float deltaRate) {
-    if (millis() - envState.lastSignCheck > config.envCheckInterval) {
+    if (m_now - envState.lastSignCheck > m_cfg.envCheckInterval) {
         // 方案B改进：当 deltaRate 很大时（手移动），清除环境检测状态
-        if (fabs(deltaRate) > config.envDeltaRateThreshold) {
+        if (fabs(deltaRate) > m_cfg.envDeltaRateThreshold) {
             // 手在移动，清除噪音计数
             envState.envCount = 0;
         }
         
         // 正常的环境噪音检测（仅当 deltaRate 较小时）
-        if (fabs(deltaRate) <= config.envDeltaRateThreshold) {
+        if (fabs(deltaRate) <= m_cfg.envDeltaRateThreshold) {
             if (envState.lastDeltaRateForEnv != 0 && deltaRate != 0) {
                 bool signChanged = (envState.lastDeltaRateForEnv > 0 && deltaRate < 0) ||
                                    (envState.lastDeltaRateForEnv < 0 && deltaRate > 0);
                 
                 if (signChanged) {
-                    envState.envCount = min(envState.envCount + 1, config.envWindow);
+                    envState.envCount = min(envState.envCount + 1, m_cfg.envWindow);
                 } else {
                     envState.envCount = max(0, envState.envCount - 2);
                 }
@@ -250,15 +438,15 @@ void ThereminEngine::detectEnvironmentJitter(float deltaRate) {
         }
         
         envState.lastDeltaRateForEnv = deltaRate;
-        envState.lastSignCheck = millis();
+        envState.lastSignCheck = m_now;
         
-        bool currentEnv = (envState.envCount >= config.envCountThreshold);
+        bool currentEnv = (envState.envCount >= m_cfg.envCountThreshold);
         if (currentEnv) {
-            envState.envStableCounter = min(envState.envStableCounter + 1, config.envStableWindow);
+            envState.envStableCounter = min(envState.envStableCounter + 1, m_cfg.envStableWindow);
             envState.envClearCounter = 0;
         } else {
             envState.envClearCounter++;
-            if (envState.envClearCounter >= config.envClearThreshold) {
+            if (envState.envClearCounter >= m_cfg.envClearThreshold) {
                 envState.envStableCounter = 0;
             }
         }
@@ -268,16 +456,16 @@ void ThereminEngine::detectEnvironmentJitter(float deltaRate) {
 
 // 静态基线调整
 void ThereminEngine::updateStaticBaseline(float delta, float deltaRate) {
-    if (delta < config.staticDeltaThreshold) {
+    if (delta < m_cfg.staticDeltaThreshold) {
         float deltaDiff = fabs(deltaRate);
         
-        if (deltaDiff < config.staticDeltaRateMax) {
+        if (deltaDiff < m_cfg.staticDeltaRateMax) {
             staticState.staticCount++;
         } else {
-            staticState.staticCount = max(0, staticState.staticCount - config.staticPenalty);
+            staticState.staticCount = max(0, staticState.staticCount - m_cfg.staticPenalty);
         }
         
-        if (staticState.staticCount > config.staticCountMax) {
+        if (staticState.staticCount > m_cfg.staticCountMax) {
             portENTER_CRITICAL(&m_baselineMux);
             freqState.smoothedBaseFreq = freqState.smoothedBaseFreq * 0.8f + freqState.smoothedFreq * 0.2f;
             freqState.frozenBaseFreq = freqState.smoothedFreq;
@@ -294,10 +482,10 @@ void ThereminEngine::updateStaticBaseline(float delta, float deltaRate) {
 void ThereminEngine::updateAdaptiveBaseline(float delta, float deltaRaw) {
     float deltaAbs = delta;
     float baseAlpha = 0.05f + deltaAbs * 0.01f;
-    float envFactor = envState.isEnvironmentalJitter ? config.envFactorValue : 0.0f;
+    float envFactor = envState.isEnvironmentalJitter ? m_cfg.envFactorValue : 0.0f;
     
     // handFactor 连续控制：二次曲线，小delta影响很小，大delta几乎完全锁死基线
-    float handRatio = delta / config.handFactorThreshold;
+    float handRatio = delta / m_cfg.handFactorThreshold;
     handRatio = handRatio * handRatio;  // 二次曲线
     float handFactor = (!envState.isEnvironmentalJitter) ?
                        baseAlpha * 0.98f * fminf(handRatio, 1.0f) : 0.0f;  // 98%抵消
@@ -312,10 +500,10 @@ void ThereminEngine::updateAdaptiveBaseline(float delta, float deltaRaw) {
     m_lastAdaptiveAlpha = adaptiveAlpha;
     
     // frozenBaseFreq 更新：稳定时快速跟随 + 无条件慢速漂移恢复（防死锁）
-    if (delta <= 0.5f && freqState.stableCount >= config.stableWindow * 0.7f &&
-        millis() - freqState.lastFrozenUpdate > config.frozenUpdateInterval) {
+    if (delta <= 0.5f && freqState.stableCount >= m_cfg.stableWindow * 0.7f &&
+        m_now - freqState.lastFrozenUpdate > m_cfg.frozenUpdateInterval) {
         freqState.frozenBaseFreq = freqState.smoothedFreq;
-        freqState.lastFrozenUpdate = millis();
+        freqState.lastFrozenUpdate = m_now;
     } else {
         // 慢速漂移恢复：delta越大漂移越慢（手靠近时几乎不漂移）
         float driftAlpha = 0.002f / fmaxf(1.0f, delta);
@@ -344,7 +532,6 @@ void ThereminEngine::initBaseline(float smoothedFreq) {
                 freqState.smoothedBaseFreq = smoothedFreq;
                 freqState.frozenBaseFreq = smoothedFreq;
                 freqState.baselineSet = true;
-                Serial.printf("Baseline set to: %.1f\n", smoothedFreq);
             }
         } else {
             initState.freqAtStartup = smoothedFreq;
@@ -353,64 +540,396 @@ void ThereminEngine::initBaseline(float smoothedFreq) {
     }
 }
 
-// PWM输出
-void ThereminEngine::updatePWM() {
-    m_duty = map(freqState.lastSmoothedDelta * 10, 
-                config.deltaFMin * 10, config.deltaFMax * 10, 0, 255);
-    m_duty = constrain(m_duty, 0, 255);
-    ledcWrite(config.pwmPin, m_duty);
+// ========================================================
+// ======= 热启动 (Warm Start) ===========================
+// ========================================================
+
+// 开机后用原始频率验证快照：连续 warmStartSamples 个样本与快照一致时直接恢复，
+// 不一致则继续等待；冷启动路径先完成时放弃快照
+void ThereminEngine::tryWarmStart(float rawFreq) {
+    if (!warmState.pending) return;
+    if (freqState.baselineSet) {
+        warmState.pending = false;
+        return;
+    }
+    
+    const BaselineSnapshot& snap = warmState.snapshot;
+    if (fabs(rawFreq - snap.smoothedFreq) > m_cfg.warmStartTolerance) {
+        warmState.confirmCount = 0;
+        warmState.confirmSum = 0;
+        return;
+    }
+    
+    warmState.confirmCount++;
+    warmState.confirmSum += rawFreq;
+    if (warmState.confirmCount < m_cfg.warmStartSamples) return;
+    
+    // 滤波状态取新鲜信号均值，基线与噪音统计取快照
+    float freshFreq = warmState.confirmSum / warmState.confirmCount;
+    portENTER_CRITICAL(&m_baselineMux);
+    freqState.smoothedFreq = freshFreq;
+    freqState.smoothedBaseFreq = snap.smoothedBaseFreq;
+    freqState.frozenBaseFreq = snap.frozenBaseFreq;
+    portEXIT_CRITICAL(&m_baselineMux);
+    freqState.lastRawFreq = freshFreq;
+    freqState.lastSmoothedDelta = snap.lastSmoothedDelta;
+    freqState.lastStableDelta = snap.lastStableDelta;
+    freqState.lastFrozenUpdate = millis();
+    envState.envCount = snap.envCount;
+    envState.envStableCounter = snap.envStableCounter;
+    freqState.baselineSet = true;
+    
+    warmState.pending = false;
+    warmState.warmStarted = true;
 }
 
-// 手动校准
-void ThereminEngine::recalibrate() {
+void ThereminEngine::armWarmStart(const BaselineSnapshot& snap) {
+    if (!m_cfg.warmStartEnable) return;
+    warmState.snapshot = snap;
+    warmState.pending = true;
+    warmState.confirmCount = 0;
+    warmState.confirmSum = 0;
+}
+
+void ThereminEngine::markBaselineValid() {
+    warmState.baselineTime = millis();
+    if (telemetry.isEnabled()) return;
+    Serial.printf("Baseline set to: %.1f (%s, %lu ms)\n",
+                  freqState.frozenBaseFreq, warmState.warmStarted ? "warm" : "cold",
+                  getTimeToBaselineMs());
+}
+
+BaselineSnapshot ThereminEngine::makeSnapshot() const {
+    BaselineSnapshot snap;
+    snap.frozenBaseFreq = freqState.frozenBaseFreq;
+    snap.smoothedBaseFreq = freqState.smoothedBaseFreq;
+    snap.smoothedFreq = freqState.smoothedFreq;
+    snap.lastRawFreq = freqState.lastRawFreq;
+    snap.lastSmoothedDelta = freqState.lastSmoothedDelta;
+    snap.lastStableDelta = freqState.lastStableDelta;
+    snap.envCount = envState.envCount;
+    snap.envStableCounter = envState.envStableCounter;
+    return snap;
+}
+
+// 仅保存已验证状态：基线已建立、无手靠近、delta稳定
+void ThereminEngine::saveSnapshot(bool force) {
+    if (!freqState.baselineSet) return;
+    if (!force) {
+        if (m_delta >= m_cfg.staticDeltaThreshold) return;
+        if (freqState.stableCount < m_cfg.stableWindow) return;
+    }
+    m_store.save(makeSnapshot(), millis(), force);
+}
+
+// ========================================================
+// ======= 空闲省电 (Idle Power) =========================
+// ========================================================
+
+// ACTIVE --(idleTimeoutMs 内无活动)--> IDLE: 降低采样率，由调用方关闭显示/暂停发送
+// IDLE --(原始 delta 超过 idleWakeDelta 或按键)--> ACTIVE
+// 唤醒判断使用未经 EMA 的原始计数与冻结基线之差，手出现后的第一个空闲样本即可唤醒
+// (平滑 delta 需要数个样本才能越过阈值)；单个噪声样本的误唤醒只多付出一次空闲超时
+// 注: ESP32-S3 light sleep 期间 PCNT/LEDC 时钟停止，频率计数会中断，
+//     因此空闲模式只降低采样率与外设负载，不进入 light sleep
+void ThereminEngine::updateIdleState(bool buttonActivity) {
+    unsigned long now = millis();
+    
+    if (idleState.idle) {
+        float rawDelta = fabs(freqState.frozenBaseFreq - m_lastInput);
+        if (rawDelta > m_cfg.idleWakeDelta || buttonActivity) {
+            idleState.idle = false;
+            idleState.idleTimeTotal += now - idleState.enteredAt;
+            idleState.wakeCount++;
+            idleState.lastActivity = now;
+            setSamplingPeriod(m_cfg.samplingPeriodMs);
+            if (!telemetry.isEnabled()) {
+                Serial.printf("Idle exit after %lu ms (active %.1f%%)\n",
+                              now - idleState.enteredAt, getActiveFraction() * 100.0f);
+            }
+        }
+        return;
+    }
+    
+    bool active = !freqState.baselineSet || buttonActivity ||
+                  m_delta > m_cfg.idleActivityDelta;
+    if (active) {
+        idleState.lastActivity = now;
+    } else if (now - idleState.lastActivity > m_cfg.idleTimeoutMs) {
+        idleState.idle = true;
+        idleState.enteredAt = now;
+        setSamplingPeriod(idleSamplingPeriod());
+        if (!telemetry.isEnabled()) Serial.println("Idle enter");
+    }
+}
+
+// 空闲采样周期: 按当前输入计数预估，保证一个周期内的计数留有10%余量不超过PCNT上限
+int ThereminEngine::idleSamplingPeriod() const {
+    float countsPerMs = m_lastInput / m_cfg.samplingPeriodMs;
+    if (countsPerMs <= 0) return m_cfg.idleSamplingPeriodMs;
+    int maxPeriod = (int)(m_cfg.pcntCountLimit * 0.9f / countsPerMs);
+    return constrain(maxPeriod, m_cfg.samplingPeriodMs, m_cfg.idleSamplingPeriodMs);
+}
+
+// 运行时修改采样周期：重启计时并丢弃跨周期的半截计数
+void ThereminEngine::setSamplingPeriod(int periodMs) {
+    if (periodMs == m_samplingPeriodMs) return;
+    
+    if (m_timer) {
+        timerStop(m_timer);
+        timerAlarm(m_timer, periodMs * 1000, true, 0);
+        timerWrite(m_timer, 0);
+        pcnt_unit_clear_count(m_pcntUnit);
+        portENTER_CRITICAL(&m_timerMux);
+        m_dataReady = false;
+        m_samplingPeriodMs = periodMs;
+        portEXIT_CRITICAL(&m_timerMux);
+        timerStart(m_timer);
+    } else {
+        m_samplingPeriodMs = periodMs;
+    }
+    
+    // 陷波器系数与采样率相关，重新学习 (分析端在收到新一代的帧时清空峰值统计)
+    m_spectrum.resetHistory();
+    portENTER_CRITICAL(&m_spectrumMux);
+    m_spectrumGen++;
+    m_spectrumFramePending = false;
+    m_notchDesignPending = false;
+    portEXIT_CRITICAL(&m_spectrumMux);
+    m_notchCount = 0;
+}
+
+float ThereminEngine::getActiveFraction() const {
+    unsigned long now = millis();
+    unsigned long uptime = now - warmState.bootTime;
+    if (uptime == 0) return 1.0f;
+    unsigned long idleTime = idleState.idleTimeTotal;
+    if (idleState.idle) idleTime += now - idleState.enteredAt;
+    return 1.0f - (float)idleTime / uptime;
+}
+
+// ========================================================
+// ======= 频谱干扰陷波 (Spectral Notch) =================
+// ========================================================
+
+float ThereminEngine::applyNotches(float freq) {
+    for (int i = 0; i < m_notchCount; i++) {
+        freq = m_notches[i].process(freq);
+    }
+    return freq;
+}
+
+// 采样路径: 每半帧 (FFT_SIZE/2 个样本) 复制一帧，FFT 在分析任务中执行
+void ThereminEngine::queueSpectrumFrame() {
+    portENTER_CRITICAL(&m_spectrumMux);
+    m_spectrum.copyFrame(m_spectrumFrame);
+    m_spectrumFrameRate = 1000.0f / m_samplingPeriodMs;
+    m_spectrumFrameGen = m_spectrumGen;
+    m_spectrumFramePending = true;
+    portEXIT_CRITICAL(&m_spectrumMux);
+    if (m_spectrumTask) xTaskNotifyGive(m_spectrumTask);
+}
+
+// 采样路径: 换入新系数，并以当前输入为稳态初始化 (滤波状态只在采样路径上读写)
+void ThereminEngine::takeNotchDesign() {
+    if (!m_notchDesignPending) return;
+    portENTER_CRITICAL(&m_spectrumMux);
+    int count = m_notchDesignCount;
+    for (int i = 0; i < count; i++) m_notches[i] = m_notchDesign[i];
+    m_notchDesignPending = false;
+    portEXIT_CRITICAL(&m_spectrumMux);
+    
+    for (int i = 0; i < count; i++) m_notches[i].prime(freqState.lastRawFreq);
+    m_notchCount = count;
+}
+
+void ThereminEngine::runSpectralAnalysis() {
+    if (m_spectrumTask) return;
+    analyzeSpectrum();
+}
+
+void ThereminEngine::spectrumTaskEntry(void* arg) {
+    ThereminEngine* engine = static_cast<ThereminEngine*>(arg);
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        engine->analyzeSpectrum();
+    }
+}
+
+// 分析端: 稳定干扰集合变化时才设计新的陷波器
+void ThereminEngine::analyzeSpectrum() {
+    if (!m_cfg.enableSpectralNotch) return;
+    
+    portENTER_CRITICAL(&m_spectrumMux);
+    bool pending = m_spectrumFramePending;
+    if (pending) memcpy(m_analysisFrame, m_spectrumFrame, sizeof(m_analysisFrame));
+    float sampleRate = m_spectrumFrameRate;
+    uint32_t gen = m_spectrumFrameGen;
+    m_spectrumFramePending = false;
+    portEXIT_CRITICAL(&m_spectrumMux);
+    if (!pending) return;
+    
+    // 采样率已变化: 峰值统计与已设计的陷波器作废
+    if (gen != m_analysisGen) {
+        m_spectrum.resetPeaks();
+        m_analysisCount = 0;
+        m_analysisGen = gen;
+    }
+    
+    float peaks[NOTCH_MAX];
+    int count = m_spectrum.analyzeFrame(m_analysisFrame, sampleRate, peaks, NOTCH_MAX);
+    
+    // 与现有陷波频率逐一比对 (半个频点以内视为同一干扰)
+    float halfBin = 0.5f * sampleRate / SpectralAnalyzer::FFT_SIZE;
+    bool changed = count != m_analysisCount;
+    for (int i = 0; i < count && !changed; i++) {
+        bool found = false;
+        for (int j = 0; j < m_analysisCount; j++) {
+            if (fabs(peaks[i] - m_analysisHz[j]) <= halfBin) found = true;
+        }
+        changed = !found;
+    }
+    if (!changed) return;
+    
+    NotchFilter design[NOTCH_MAX];
+    for (int i = 0; i < count; i++) {
+        design[i].configure(peaks[i], sampleRate, m_cfg.notchQ);
+        m_analysisHz[i] = peaks[i];
+    }
+    m_analysisCount = count;
+    
+    // 发布期间采样率又变化时丢弃 (下一代的帧会重新分析)
+    portENTER_CRITICAL(&m_spectrumMux);
+    if (gen == m_spectrumGen) {
+        for (int i = 0; i < count; i++) m_notchDesign[i] = design[i];
+        m_notchDesignCount = count;
+        m_notchDesignPending = true;
+    }
+    portEXIT_CRITICAL(&m_spectrumMux);
+    
+    if (telemetry.isEnabled()) return;
+    Serial.printf("Notch: %d filter(s)", count);
+    for (int i = 0; i < count; i++) Serial.printf(" %.2fHz", peaks[i]);
+    Serial.printf(" | fft %luus max %luus | jitter looking changes %lu\n",
+                  (unsigned long)m_spectrum.getLastFftMicros(),
+                  (unsigned long)m_spectrum.getMaxFftMicros(),
+                  (unsigned long)envState.jitterLookingChanges);
+}
+
+// ========================================================
+// ======= 按键与校准 (Button & Calibration) =============
+// ========================================================
+
+// 按键: 松开时 < curveLongPressMs 为短按 (基线校准)，按住超过为长按 (曲线校准)
+// 去抖: 电平须保持 buttonDebounceMs 才判定按下/松开；采样间隙内的抖动 (中断标志) 重新计时。
+// 长按触发后等待稳定松开，松开时的抖动不会再判为短按
+// 返回是否有按键活动
+bool ThereminEngine::handleButton() {
     bool pressed = false;
     portENTER_CRITICAL(&m_timerMux);
     pressed = m_buttonPressed;
     if (pressed) m_buttonPressed = false;
     portEXIT_CRITICAL(&m_timerMux);
     
-    if (pressed) {
-        portENTER_CRITICAL(&m_baselineMux);
-        freqState.smoothedBaseFreq = freqState.smoothedFreq;
-        freqState.frozenBaseFreq = freqState.smoothedFreq;
-        portEXIT_CRITICAL(&m_baselineMux);
-        freqState.stableCount = 0;
+    unsigned long now = millis();
+    bool held = digitalRead(m_cfg.buttonPin) == LOW;
+    if (held != calState.held || pressed) {
+        calState.held = held;
+        calState.levelSince = now;
+    }
+    bool stable = now - calState.levelSince >= m_cfg.buttonDebounceMs;
+    
+    if (calState.waitRelease) {
+        if (!held && stable) calState.waitRelease = false;
+        return true;
     }
+    
+    if (!calState.pressTracking) {
+        if (held && stable) {
+            calState.pressTracking = true;
+            calState.pressStart = calState.levelSince;
+        }
+        return pressed || held;
+    }
+    
+    if (!held) {
+        if (stable) {
+            calState.pressTracking = false;
+            recalibrate();
+        }
+    } else if (now - calState.pressStart >= m_cfg.curveLongPressMs) {
+        calState.pressTracking = false;
+        calState.waitRelease = true;
+        if (m_cfg.enableResponseCurve) {
+            startCurveCalibration();
+        } else {
+            recalibrate();
+        }
+    }
+    return true;
 }
 
-// 调试输出
-void ThereminEngine::debugOutput() {
-#if DEBUG_MODE_ALPHA
-    static unsigned long lastAlphaPrint = 0;
-    if (millis() - lastAlphaPrint > 100) {
-        float deltaRaw = freqState.frozenBaseFreq - freqState.smoothedFreq;
-        Serial.printf("dR:%.2f es:%d sc:%d ba:%.3f ef:%.3f hf:%.3f a:%.4f\n",
-                    deltaRaw, envState.envStableCounter, staticState.staticCount,
-                    m_lastBaseAlpha, m_lastEnvFactor, m_lastHandFactor, m_lastAdaptiveAlpha);
-        lastAlphaPrint = millis();
-    }
-#endif
-
-#if DEBUG_MODE_PLOTTER
-    static unsigned long lastPlotterPrint = 0;
-    if (millis() - lastPlotterPrint > 50) {
-        Serial.print(freqState.smoothedFreq);
-        Serial.print(" ");
-        Serial.print(freqState.smoothedBaseFreq);
-        Serial.print(" ");
-        Serial.print(m_delta);
-        Serial.print(" ");
-        Serial.println(freqState.deltaRate);
-        lastPlotterPrint = millis();
-    }
-#endif
-
-#if DEBUG_MODE_SIMPLE
-    static unsigned long lastSimplePrint = 0;
-    if (millis() - lastSimplePrint > 100) {
-        Serial.printf("Freq: %.1f | Base: %.1f | d: %.2f | L: %d\n",
-                    freqState.smoothedFreq, freqState.smoothedBaseFreq, m_delta, stabState.looking);
-        lastSimplePrint = millis();
-    }
-#endif
+// 手动校准
+void ThereminEngine::recalibrate(bool persist) {
+    portENTER_CRITICAL(&m_baselineMux);
+    freqState.smoothedBaseFreq = freqState.smoothedFreq;
+    freqState.frozenBaseFreq = freqState.smoothedFreq;
+    portEXIT_CRITICAL(&m_baselineMux);
+    freqState.stableCount = 0;
+    calState.recalibrations++;
+    if (persist) saveSnapshot(true);
+}
+
+// 响应曲线校准：扫动期间记录平滑delta，结束时拟合并保存
+void ThereminEngine::startCurveCalibration() {
+    calState.sweepStart = millis();
+    m_curve.beginSweep();
+    if (!telemetry.isEnabled()) {
+        Serial.printf("Curve calibration: sweep hand far -> near for %lu ms\n", m_cfg.curveSweepMs);
+    }
+}
+
+void ThereminEngine::updateCurveCalibration() {
+    m_curve.addSample(freqState.lastSmoothedDelta);
+    if (millis() - calState.sweepStart < m_cfg.curveSweepMs) return;
+    
+    if (!m_curve.finishSweep()) {
+        if (!telemetry.isEnabled()) Serial.println("Curve calibration failed: not enough hand samples");
+        return;
+    }
+    bool saved = m_curve.save();
+    if (telemetry.isEnabled()) return;
+    Serial.printf("Curve calibrated: delta %.1f..%.1f%s\n", m_curve.getMinDelta(), m_curve.getMaxDelta(),
+                  saved ? "" : " (NVS save failed)");
+}
+
+// 遥测输出 (全采样率，字段由 telemetry 的掩码在运行时选择)
+void ThereminEngine::publishTelemetry() {
+    if (!telemetry.isEnabled()) return;
+    
+    float v[TF_COUNT];
+    v[TF_RAW_COUNT] = m_lastInput;
+    v[TF_SMOOTHED_FREQ] = freqState.smoothedFreq;
+    v[TF_SMOOTHED_BASE] = freqState.smoothedBaseFreq;
+    v[TF_FROZEN_BASE] = freqState.frozenBaseFreq;
+    v[TF_DELTA_RAW] = freqState.frozenBaseFreq - freqState.smoothedFreq;
+    v[TF_DELTA] = m_delta;
+    v[TF_SMOOTHED_DELTA] = freqState.lastSmoothedDelta;
+    v[TF_DELTA_RATE] = freqState.deltaRate;
+    v[TF_LOOKING] = stabState.smoothedLooking;
+    v[TF_DUTY] = m_duty;
+    v[TF_DIRECTION] = stabState.direction;
+    v[TF_ENV_COUNT] = envState.envCount;
+    v[TF_ENV_STABLE_COUNTER] = envState.envStableCounter;
+    v[TF_ENV_JITTER] = envState.isEnvironmentalJitter;
+    v[TF_STATIC_COUNT] = staticState.staticCount;
+    v[TF_STABLE_COUNT] = freqState.stableCount;
+    v[TF_BASE_ALPHA] = m_lastBaseAlpha;
+    v[TF_ENV_FACTOR] = m_lastEnvFactor;
+    v[TF_HAND_FACTOR] = m_lastHandFactor;
+    v[TF_ADAPTIVE_ALPHA] = m_lastAdaptiveAlpha;
+    v[TF_NOTCH_COUNT] = m_notchCount;
+    v[TF_IDLE] = idleState.idle;
+    v[TF_DROPPED] = telemetry.getDroppedCount();
+    telemetry.publish(m_now, v);
 }
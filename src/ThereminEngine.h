@@ -4,6 +4,11 @@
 #include <Arduino.h>
 #include "driver/pulse_cnt.h"
 #include "config.h"
+#include "BaselineStore.h"
+#include "SpectralAnalyzer.h"
+#include "ResponseCurve.h"
+#include "OutputQuantizer.h"
+#include "Telemetry.h"
 
 // ========================================================
 // ======= 状态结构体 (State Management) ===============
@@ -38,6 +43,7 @@ struct EnvironmentState {
     int envStableCounter = 0;
     int envClearCounter = 0;
     unsigned long lastSignCheck = 0;
+    uint32_t jitterLookingChanges = 0;  // 环境抖动期间looking变化次数
 };
 
 // 静态调整状态
@@ -52,31 +58,117 @@ struct InitState {
     int initCount = 0;
 };
 
+// 热启动状态
+struct WarmStartState {
+    BaselineSnapshot snapshot;          // 待验证的快照
+    bool pending = false;               // 快照尚未被确认或放弃
+    bool warmStarted = false;           // 本次基线由快照恢复
+    int confirmCount = 0;               // 连续一致样本数
+    float confirmSum = 0;               // 一致样本累加 (恢复时取均值)
+    unsigned long bootTime = 0;
+    unsigned long baselineTime = 0;     // 首次有效输出时刻
+};
+
+// 空闲省电状态
+struct IdleState {
+    bool idle = false;
+    unsigned long lastActivity = 0;     // 最近一次活动时刻
+    unsigned long enteredAt = 0;        // 本次进入空闲的时刻
+    unsigned long idleTimeTotal = 0;    // 累计空闲时长 (毫秒)
+    uint32_t wakeCount = 0;
+};
+
+// 按键与响应曲线校准状态
+struct CalibrationState {
+    bool pressTracking = false;         // 正在区分短按/长按
+    bool waitRelease = false;           // 长按已触发，等待稳定松开后才重新响应
+    bool held = false;                  // 最近一次读到的按键电平 (按下)
+    unsigned long levelSince = 0;       // 该电平开始时刻 (去抖计时)
+    unsigned long pressStart = 0;
+    unsigned long sweepStart = 0;       // 曲线校准扫动开始时刻
+    uint32_t recalibrations = 0;        // 基线重校准次数 (影子管线据此镜像)
+};
+
+// 块处理单样本输出
+struct EngineOutput {
+    float delta = 0;                // |frozenBase - smoothedFreq|
+    float smoothedDelta = 0;        // 平滑后的delta
+    int8_t direction = 0;           // 频率变化方向 (-1, 0, 1)
+    uint8_t looking = 0;            // 量化后的眼睛方向 (0-8), 同 getLooking()
+    uint8_t duty = 0;               // 量化后的PWM占空比 (0-255)
+};
+
 // ========================================================
 // ======= ThereminEngine 类 ============================
 // ========================================================
 
 class ThereminEngine {
 public:
-    ThereminEngine();
+    // cfg 须在引擎生命周期内有效；默认使用全局配置
+    explicit ThereminEngine(ThereminConfig& cfg = config);
     
     // 初始化
     bool begin();
+    bool beginOffline();
+    
+    // 主循环处理 (返回是否处理了新样本)
+    bool process();
+    
+    // 块处理：对连续的计数缓冲 (已折算到 samplingPeriodMs) 执行纯滤波计算，
+    // 不访问硬件；样本时间戳为 firstSampleMs + i × 当前采样周期
+    size_t processBlock(const float* counts, EngineOutput* out, size_t count,
+                        unsigned long firstSampleMs);
+    
+    // 离线单样本 (影子管线)：与 process() 相同的热启动确认 + 块处理，
+    // 不访问硬件、不写快照、不输出串口文本
+    void processOffline(float count, EngineOutput& out, unsigned long now);
     
-    // 主循环处理
-    void process();
+    // 影子实例：使用主引擎启动时读到的同一基线快照热启动 (本配置关闭热启动时忽略)
+    void armWarmStart(const BaselineSnapshot& snap);
+    bool hasWarmSnapshot() const { return warmState.pending || warmState.warmStarted; }
+    const BaselineSnapshot& getWarmSnapshot() const { return warmState.snapshot; }
     
     // 获取当前状态
-    int getLooking() const { return (int)stabState.smoothedLooking; }
+    int getLooking() const { return m_quant.getLooking(); }
     int getDuty() const { return m_duty; }
     int getDirection() const { return stabState.direction; }
     float getDelta() const { return m_delta; }
+    float getSmoothedDelta() const { return freqState.lastSmoothedDelta; }
+    float getDeltaRate() const { return freqState.deltaRate; }
     float getSmoothedFreq() const { return freqState.smoothedFreq; }
     float getSmoothedBaseFreq() const { return freqState.smoothedBaseFreq; }
+    float getFrozenBaseFreq() const { return freqState.frozenBaseFreq; }
+    float getLastInput() const { return m_lastInput; }
     bool isBaselineSet() const { return freqState.baselineSet; }
+    bool isWarmStarted() const { return warmState.warmStarted; }
+    bool isIdle() const { return idleState.idle; }
+    int getSamplingPeriodMs() const { return m_samplingPeriodMs; }
+    uint32_t getRecalibrationCount() const { return calState.recalibrations; }
+    bool isEnvironmentalJitter() const { return envState.isEnvironmentalJitter; }
+    float getActiveFraction() const;
+    unsigned long getTimeToBaselineMs() const {
+        return freqState.baselineSet ? warmState.baselineTime - warmState.bootTime : 0;
+    }
     
-    // 手动校准
-    void recalibrate();
+    // 手动校准 (短按: 基线；长按: 响应曲线扫动)
+    // persist=false 时不写快照 (影子实例镜像主引擎的校准)
+    void recalibrate(bool persist = true);
+    void startCurveCalibration();
+    bool isCalibratingCurve() const { return m_curve.isSweeping(); }
+    bool hasResponseCurve() const { return m_curve.isValid(); }
+    
+    // 频谱分析 + 陷波器设计: begin() 启动的低优先级任务中运行，有该任务时直接返回；
+    // 无任务时 (离线/影子实例、任务创建失败) 由调用方在采样之外调用。
+    // 新系数由采样路径在下一个样本前取用
+    void runSpectralAnalysis();
+    int getNotchCount() const { return m_notchCount; }
+    TaskHandle_t getSpectrumTaskHandle() const { return m_spectrumTask; }
+    
+    // 切换采样周期 (陷波器重新学习)；离线实例无定时器，只更新折算与频谱采样率
+    void setSamplingPeriod(int periodMs);
+    uint32_t getJitterLookingChanges() const { return envState.jitterLookingChanges; }
+    const QuantizerStats& getQuantizerStats() const { return m_quant.getStats(); }
+    TaskHandle_t getStorageTaskHandle() const { return m_store.getTaskHandle(); }
     
 private:
     // 硬件初始化
@@ -86,6 +178,7 @@ private:
     void setupButton();
     
     // 频率处理
+    void processFilters(float currentFreq);
     float filterFrequency(float currentFreq, float smoothedFreq);
     float filterDelta(float delta, float lastSmoothedDelta);
     void updateStability(float delta);
@@ -94,18 +187,69 @@ private:
     void updateAdaptiveBaseline(float delta, float deltaRaw);
     void initBaseline(float smoothedFreq);
     
-    // 输出
-    void updatePWM();
+    // 热启动
+    void tryWarmStart(float rawFreq);
+    void markBaselineValid();
+    BaselineSnapshot makeSnapshot() const;
+    void saveSnapshot(bool force = false);
+    
+    // 按键与曲线校准
+    bool handleButton();
+    void updateCurveCalibration();
     
-    // 调试输出
-    void debugOutput();
+    // 空闲省电
+    void updateIdleState(bool buttonActivity);
+    int idleSamplingPeriod() const;
+    
+    // 干扰陷波
+    float applyNotches(float freq);
+    void queueSpectrumFrame();          // 采样路径: 交出一帧给分析端
+    void takeNotchDesign();             // 采样路径: 取用分析端发布的陷波系数
+    void analyzeSpectrum();             // 分析端: FFT + 陷波器设计
+    static void spectrumTaskEntry(void* arg);
+    
+    // 遥测输出
+    void publishTelemetry();
     
     // 成员变量
+    ThereminConfig& m_cfg;
+    
     FrequencyState freqState;
     EyeState stabState;
     EnvironmentState envState;
     StaticAdjustState staticState;
     InitState initState;
+    WarmStartState warmState;
+    IdleState idleState;
+    CalibrationState calState;
+    
+    BaselineStore m_store;
+    
+    SpectralAnalyzer m_spectrum;
+    NotchFilter m_notches[NOTCH_MAX];
+    int m_notchCount = 0;
+    
+    // 采样路径 ⇄ 频谱分析任务 (帧与系数各只保留最新一份)
+    // m_spectrumGen 在采样率变化时递增，之前的帧与系数作废
+    TaskHandle_t m_spectrumTask = NULL;
+    portMUX_TYPE m_spectrumMux;
+    uint32_t m_spectrumGen = 0;
+    float m_spectrumFrame[SpectralAnalyzer::FFT_SIZE];
+    float m_spectrumFrameRate = 0;
+    uint32_t m_spectrumFrameGen = 0;
+    volatile bool m_spectrumFramePending = false;
+    NotchFilter m_notchDesign[NOTCH_MAX];
+    int m_notchDesignCount = 0;
+    volatile bool m_notchDesignPending = false;
+    
+    // 分析端状态 (仅分析任务读写)
+    float m_analysisFrame[SpectralAnalyzer::FFT_SIZE];
+    float m_analysisHz[NOTCH_MAX];
+    int m_analysisCount = 0;
+    uint32_t m_analysisGen = 0;
+    
+    ResponseCurve m_curve;
+    OutputQuantizer m_quant;
     
     pcnt_unit_handle_t m_pcntUnit;
     pcnt_channel_handle_t m_pcntChannel;
@@ -117,8 +261,11 @@ private:
     
     int m_duty;
     float m_delta;
+    int m_samplingPeriodMs;             // 当前采样周期 (空闲时加长)
+    unsigned long m_now = 0;            // 当前样本时间戳 (毫秒)
+    float m_lastInput = 0;              // 最近一次折算后的输入计数 (未陷波)
 
-    // 调试缓存 (避免debugOutput重复计算)
+    // 遥测缓存 (自适应基线中间量)
     float m_lastBaseAlpha = 0;
     float m_lastEnvFactor = 0;
     float m_lastHandFactor = 0;
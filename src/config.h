@@ -1,6 +1,8 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <cstdint>
+
 // ========================================================
 // ======= 硬件引脚定义 (Hardware Pins) =================
 // ========================================================
@@ -10,7 +12,17 @@
 #define LED_DIN_PIN         17  // LED矩阵数据引脚 (MAX7219 DIN)
 #define LED_CLK_PIN         15  // LED矩阵时钟引脚 (MAX7219 CLK)
 #define LED_CS_PIN          16  // LED矩阵片选引脚 (MAX7219 CS)
-#define LED_MODULE_COUNT    8   // LED矩阵模块数量 (8x8点阵)
+#define LED_MODULE_COUNT    8   // LED矩阵模块总数 (8x8点阵)，按顺序平均分配到各链
+#define LED_INTENSITY       8   // LED矩阵正常亮度 (0-15)
+
+// 多链输出: 每条 MAX7219 链独占一个 SPI 主机 (DMA)，各链并行刷新
+#define LED_MODULE_MAX      32  // 帧缓冲最大模块数
+#define LED_CHAIN_MAX       2   // 最大链数 (ESP32-S3 可用 SPI2/SPI3)
+#define LED_CHAIN_COUNT     1   // 使用的链数 (第1条链使用上面的 DIN/CLK/CS)
+#define LED_CHAIN2_DIN_PIN  11  // 第2条链数据引脚
+#define LED_CHAIN2_CLK_PIN  12  // 第2条链时钟引脚
+#define LED_CHAIN2_CS_PIN   10  // 第2条链片选引脚
+#define LED_SPI_CLOCK_HZ    8000000  // SPI时钟 (MAX7219 上限 10MHz)
 
 // ========================================================
 // ======= 算法参数 (Algorithm Parameters) ===============
@@ -18,6 +30,9 @@
 
 // 采样与稳定
 #define SAMPLING_PERIOD_MS  20  // 采样周期 (毫秒) - 10ms = 40Hz采样
+#define PCNT_COUNT_LIMIT    32767   // PCNT 计数上限 (16位有符号)，每个采样周期的计数不得超过
+#define PCNT_MAX_INPUT_HZ   500000  // 设计输入频率上限 (Hz)，用于检查各采样周期不会溢出
+#define BLOCK_MAX_SAMPLES   64  // processBlock 内部分块大小 (栈上缓冲)
 #define STABLE_WINDOW       20  // 稳定窗口大小 (采样次数)50 //20
 #define STABILITY_THRESHOLD 0.2f  // 稳定性判断阈值 (Hz)
 #define DIRECTION_THRESHOLD 0.2f // 方向判断阈值
@@ -66,14 +81,131 @@
 #define HAND_FACTOR_COEFF      0.03f  // 手动因子系数
 #define FROZEN_UPDATE_INTERVAL 3000  // frozenBaseFreq更新间隔 (毫秒)
 
+// ========================================================
+// ======= 热启动参数 (Warm Start) =======================
+// ========================================================
+#define WARM_START_TOLERANCE     20.0f   // 快照基线与开机原始频率允许偏差 (Hz)
+#define WARM_START_SAMPLES       3       // 热启动一致性确认样本数
+#define SNAPSHOT_RTC_INTERVAL    1000    // RTC快照间隔 (毫秒)
+#define SNAPSHOT_NVS_INTERVAL    600000  // NVS最小写入间隔 (毫秒, 10分钟, 防flash磨损)
+#define SNAPSHOT_NVS_MIN_CHANGE  2.0f    // NVS写入所需的最小基线变化 (Hz)
+#define SNAPSHOT_NVS_TASK_STACK  3072    // NVS写入任务栈大小 (字节, 低优先级)
+#define SNAPSHOT_NVS_TASK_CORE   0       // NVS写入任务所在核心 (主循环在Core 1)
+
+// ========================================================
+// ======= 空闲省电参数 (Idle Power) =====================
+// ========================================================
+#define IDLE_TIMEOUT_MS          300000  // 无活动多久进入空闲 (毫秒, 5分钟)
+#define IDLE_SAMPLING_PERIOD_MS  60      // 空闲采样周期 (毫秒), 输入频率过高时按PCNT上限自动缩短
+#define IDLE_ACTIVITY_DELTA      1.5f    // 判定为活动的delta (Hz)
+#define IDLE_WAKE_DELTA          2.0f    // 空闲时唤醒delta阈值 (Hz)
+#define IDLE_DISPLAY_INTENSITY   -1      // 空闲显示亮度 (0-15), -1 = 关闭MAX7219
+#define IDLE_LOOP_DELAY_MS       10      // 空闲时主循环让出CPU的时间 (毫秒)
+#define IDLE_ESPNOW_POLL_MS      50      // 空闲时ESP-NOW任务轮询间隔 (毫秒)
+
+// ========================================================
+// ======= 手势识别参数 (Gesture) ========================
+// ========================================================
+#define GESTURE_PRESENCE_ON     3.0f   // 手出现delta阈值 (Hz)
+#define GESTURE_PRESENCE_OFF    2.0f   // 手离开delta阈值 (Hz, 迟滞)
+#define GESTURE_MIN_MS          60     // 最短有效手势 (毫秒), 更短视为噪音
+#define GESTURE_SHORT_MS        400    // 短手势上限 (毫秒): 以内离开判为 tap/swipe
+#define GESTURE_TAP_PEAK        9.0f   // tap 峰值delta (Hz), 低于此为 swipe
+#define GESTURE_HOVER_SLOPE     0.05f  // 悬停判定斜率 (Hz/样本)
+#define GESTURE_HOVER_MS        600    // 悬停持续时间 (毫秒)
+
+// ========================================================
+// ======= 频谱干扰分析参数 (Spectral Notch) =============
+// ========================================================
+#define SPECTRUM_FFT_SIZE       64     // FFT点数 (2的幂), 50Hz采样约1.3秒窗口
+#define SPECTRUM_MIN_HZ         3.0f   // 低于此频率视为手部运动，不做陷波 (Hz)
+#define SPECTRUM_PEAK_RATIO     8.0f   // 干扰峰判定: 峰值功率 / 平均功率
+#define SPECTRUM_STABLE_FRAMES  4      // 峰值持续帧数 → 判定为稳定干扰
+#define NOTCH_MAX               2      // 最大陷波器数量
+#define NOTCH_Q                 4.0f   // 陷波器品质因数
+#define SPECTRUM_TASK_CORE      0      // 频谱分析任务所在核心 (主循环在Core 1)
+#define SPECTRUM_TASK_STACK     3072   // 频谱分析任务栈大小 (字节, 低优先级)
+
+// ========================================================
+// ======= 响应曲线校准参数 (Response Curve) =============
+// ========================================================
+#define BUTTON_DEBOUNCE_MS      40     // 按键电平须保持此时长才判定按下/松开 (毫秒)
+#define CURVE_LONG_PRESS_MS     2000   // 长按校准按钮进入曲线校准 (毫秒)
+#define CURVE_SWEEP_MS          8000   // 校准扫动时长 (毫秒)
+#define CURVE_NOISE_DELTA       1.0f   // 低于此delta视为无手，不参与拟合 (Hz)
+#define CURVE_MIN_SAMPLES       100    // 拟合所需最少有效样本
+#define CURVE_HIST_MAX_DELTA    40.0f  // 校准直方图上限 (Hz)
+#define CURVE_HIST_BINS         64     // 校准直方图分箱数
+#define CURVE_LUT_SIZE          17     // 查找表点数
+
+// ========================================================
+// ======= 影子管线参数 (Shadow A/B) =====================
+// ========================================================
+#define SHADOW_QUEUE_LEN          32     // 影子样本队列长度
+#define SHADOW_TASK_CORE          0      // 影子任务所在核心 (主循环在Core 1)
+#define SHADOW_TASK_STACK         4096   // 影子任务栈大小 (字节)
+#define SHADOW_REPORT_MS          5000   // 分歧统计输出间隔 (毫秒)
+#define SHADOW_LATENCY_WINDOW_MS  1000   // 响应延迟配对窗口 (毫秒)
+
+// ========================================================
+// ======= 二进制遥测参数 (Telemetry) ====================
+// ========================================================
+#define TELEMETRY_DEFAULT_FIELDS  0      // 开机字段掩码 (0 = 关闭, 串口命令 T<hex> 运行时修改)
+#define TELEMETRY_BUFFER_SIZE     4096   // 遥测流缓冲 (字节)
+#define TELEMETRY_TASK_CORE       0      // 遥测输出任务所在核心
+#define TELEMETRY_TASK_STACK      2048   // 遥测输出任务栈大小 (字节)
+
+// ========================================================
+// ======= 输出量化参数 (Output Quantizer) ===============
+// ========================================================
+#define QUANT_LOOKING_HYSTERESIS  0.3f   // looking 滞回带 (级)，越过当前级边界该距离才切换
+#define QUANT_MIN_DWELL_MS        80     // looking 两次切换的最短间隔 (毫秒)
+#define QUANT_LOOKING_MAX_STEP    0      // looking 每次切换最多变化级数 (0 = 不限)
+#define QUANT_DUTY_HYSTERESIS     4      // duty 变化超过该值才输出 (到达 0/255 时总是输出)
+#define QUANT_DUTY_SLEW           0      // duty 每样本最大变化 (0 = 不限)
+
+// ========================================================
+// ======= 资源监控参数 (Resource Monitor) ===============
+// ========================================================
+#define ESPNOW_TASK_STACK         2048   // ESP-NOW发送任务栈大小 (字节)
+#define RESOURCE_REPORT_MS        10000  // 栈水位/堆报告间隔 (毫秒)
+#define RESOURCE_ALLOC_POLICY     1      // setup()后 operator new: 0 = 不计, 1 = 计数报告, 2 = abort
+
+// ========================================================
+// ======= 诊断可视化参数 (Diagnostic View) ==============
+// ========================================================
+#define VIEW_FRAME_MS             33     // 滚动帧间隔 (毫秒, 约30fps)，串口命令 V 切换
+#define VIEW_BASE_COUNTS_PER_ROW  2.0f   // 基线轨迹: 每行对应的计数偏移
+
+// ========================================================
+// ======= 接收端播放参数 (Receiver Playout) =============
+// ========================================================
+#define JITTER_BUFFER_SIZE        16     // 抖动缓冲样本数
+#define PLAYOUT_PERIOD_MS         10     // 播放时钟周期 (与发送端节流一致)
+#define PLAYOUT_MIN_DELAY_MS      20     // 最小播放延迟 (毫秒)
+#define PLAYOUT_MAX_DELAY_MS      200    // 最大播放延迟 (毫秒)
+#define PLAYOUT_JITTER_GAIN       3.0f   // 播放延迟 = 最小延迟 + 增益 × 抖动估计
+#define PLAYOUT_OFFSET_WINDOW_MS  10000  // 时钟偏移 (最小传输时间) 估计窗口
+#define PLAYOUT_RESYNC_SEQ        64     // 序号回退超过此值视为发送端重启，清空缓冲重新同步
+#define PLAYOUT_RESYNC_MS         2000   // 发送端时间戳回退超过此值 (毫秒) 视为发送端重启
+#define RECEIVER_STATS_MS         5000   // 接收统计输出间隔 (毫秒)
+
 // ========================================================
 // ======= 功能开关 (Feature Flags) ======================
 // ========================================================
 #define ENABLE_ESPNOW       true
 #define AUTO_SET_BASE       true
-#define DEBUG_MODE_PLOTTER  false   // 串口绘图器模式
-#define DEBUG_MODE_SIMPLE   false   // 简单调试模式
-#define DEBUG_MODE_ALPHA    true    // alpha系数调试模式
+#define WARM_START_ENABLE   true    // 从RTC/NVS快照恢复基线
+#define IDLE_POWER_ENABLE   true    // 空闲省电模式
+#define ENABLE_GESTURES     true    // 手势识别 (回调)
+#define ENABLE_GESTURE_RADIO false  // 手势事件 ESP-NOW 广播 (不校验包长的旧接收端会误读，确认接收端已更新再开启)
+#define ENABLE_STATE_SEQ    false   // 状态包带序号/时间戳 (18字节; 按12字节校验包长的旧接收端会全部丢弃，接收端更新后再开启)
+#define ENABLE_SPECTRAL_NOTCH true  // 频谱干扰分析 + 自动陷波
+#define ENABLE_RESPONSE_CURVE true  // 使用学习的响应曲线 (未校准时回退线性映射)
+#define ENABLE_SHADOW_PIPELINE false // A/B调参: 第二核运行影子管线 (main.cpp setupShadowConfig)
+#define ENABLE_TELEMETRY    true    // 二进制遥测通道 (字段掩码为0时不输出)
+#define ENABLE_OUTPUT_QUANTIZER true // looking/duty 滞回 + 驻留 + 限速 (关闭时直通)
+#define ENABLE_RESOURCE_MONITOR true // 周期输出任务栈水位、堆碎片、初始化后分配计数
 
 // ========================================================
 // ======= 配置结构体 (Runtime Configuration) ============
@@ -88,9 +220,16 @@ struct ThereminConfig {
     int ledClkPin = LED_CLK_PIN;
     int ledCsPin = LED_CS_PIN;
     int ledModuleCount = LED_MODULE_COUNT;
+    int ledIntensity = LED_INTENSITY;
+    int ledChainCount = LED_CHAIN_COUNT;
+    int ledChain2DinPin = LED_CHAIN2_DIN_PIN;
+    int ledChain2ClkPin = LED_CHAIN2_CLK_PIN;
+    int ledChain2CsPin = LED_CHAIN2_CS_PIN;
+    int ledSpiClockHz = LED_SPI_CLOCK_HZ;
     
     // 算法
     int samplingPeriodMs = SAMPLING_PERIOD_MS;
+    int pcntCountLimit = PCNT_COUNT_LIMIT;
     int stableWindow = STABLE_WINDOW;
     float deltaFMin = DELTA_F_MIN;
     float deltaFMax = DELTA_F_MAX;
@@ -129,12 +268,102 @@ struct ThereminConfig {
     float handFactorCoeff = HAND_FACTOR_COEFF;
     int frozenUpdateInterval = FROZEN_UPDATE_INTERVAL;
     
+    // 热启动
+    float warmStartTolerance = WARM_START_TOLERANCE;
+    int warmStartSamples = WARM_START_SAMPLES;
+    unsigned long snapshotRtcInterval = SNAPSHOT_RTC_INTERVAL;
+    unsigned long snapshotNvsInterval = SNAPSHOT_NVS_INTERVAL;
+    float snapshotNvsMinChange = SNAPSHOT_NVS_MIN_CHANGE;
+    int snapshotNvsTaskStack = SNAPSHOT_NVS_TASK_STACK;
+    int snapshotNvsTaskCore = SNAPSHOT_NVS_TASK_CORE;
+    
+    // 空闲省电
+    unsigned long idleTimeoutMs = IDLE_TIMEOUT_MS;
+    int idleSamplingPeriodMs = IDLE_SAMPLING_PERIOD_MS;
+    float idleActivityDelta = IDLE_ACTIVITY_DELTA;
+    float idleWakeDelta = IDLE_WAKE_DELTA;
+    int idleDisplayIntensity = IDLE_DISPLAY_INTENSITY;
+    int idleLoopDelayMs = IDLE_LOOP_DELAY_MS;
+    int idleEspNowPollMs = IDLE_ESPNOW_POLL_MS;
+    
+    // 手势识别
+    float gesturePresenceOn = GESTURE_PRESENCE_ON;
+    float gesturePresenceOff = GESTURE_PRESENCE_OFF;
+    unsigned long gestureMinMs = GESTURE_MIN_MS;
+    unsigned long gestureShortMs = GESTURE_SHORT_MS;
+    float gestureTapPeak = GESTURE_TAP_PEAK;
+    float gestureHoverSlope = GESTURE_HOVER_SLOPE;
+    unsigned long gestureHoverMs = GESTURE_HOVER_MS;
+    
+    // 频谱干扰分析
+    float spectrumMinHz = SPECTRUM_MIN_HZ;
+    float spectrumPeakRatio = SPECTRUM_PEAK_RATIO;
+    int spectrumStableFrames = SPECTRUM_STABLE_FRAMES;
+    float notchQ = NOTCH_Q;
+    int spectrumTaskCore = SPECTRUM_TASK_CORE;
+    int spectrumTaskStack = SPECTRUM_TASK_STACK;
+    
+    // 响应曲线校准
+    unsigned long buttonDebounceMs = BUTTON_DEBOUNCE_MS;
+    unsigned long curveLongPressMs = CURVE_LONG_PRESS_MS;
+    unsigned long curveSweepMs = CURVE_SWEEP_MS;
+    float curveNoiseDelta = CURVE_NOISE_DELTA;
+    int curveMinSamples = CURVE_MIN_SAMPLES;
+    float curveHistMaxDelta = CURVE_HIST_MAX_DELTA;
+    
+    // 影子管线
+    int shadowQueueLen = SHADOW_QUEUE_LEN;
+    int shadowTaskCore = SHADOW_TASK_CORE;
+    int shadowTaskStack = SHADOW_TASK_STACK;
+    unsigned long shadowReportMs = SHADOW_REPORT_MS;
+    unsigned long shadowLatencyWindowMs = SHADOW_LATENCY_WINDOW_MS;
+    
+    // 二进制遥测
+    uint32_t telemetryDefaultFields = TELEMETRY_DEFAULT_FIELDS;
+    int telemetryBufferSize = TELEMETRY_BUFFER_SIZE;
+    int telemetryTaskCore = TELEMETRY_TASK_CORE;
+    int telemetryTaskStack = TELEMETRY_TASK_STACK;
+    
+    // 输出量化
+    float quantLookingHysteresis = QUANT_LOOKING_HYSTERESIS;
+    unsigned long quantMinDwellMs = QUANT_MIN_DWELL_MS;
+    int quantLookingMaxStep = QUANT_LOOKING_MAX_STEP;
+    int quantDutyHysteresis = QUANT_DUTY_HYSTERESIS;
+    int quantDutySlew = QUANT_DUTY_SLEW;
+    
+    // 资源监控
+    int espNowTaskStack = ESPNOW_TASK_STACK;
+    unsigned long resourceReportMs = RESOURCE_REPORT_MS;
+    uint8_t resourceAllocPolicy = RESOURCE_ALLOC_POLICY;
+    
+    // 诊断可视化
+    unsigned long viewFrameMs = VIEW_FRAME_MS;
+    float viewBaseCountsPerRow = VIEW_BASE_COUNTS_PER_ROW;
+    
+    // 接收端播放
+    unsigned long playoutPeriodMs = PLAYOUT_PERIOD_MS;
+    unsigned long playoutMinDelayMs = PLAYOUT_MIN_DELAY_MS;
+    unsigned long playoutMaxDelayMs = PLAYOUT_MAX_DELAY_MS;
+    float playoutJitterGain = PLAYOUT_JITTER_GAIN;
+    unsigned long playoutOffsetWindowMs = PLAYOUT_OFFSET_WINDOW_MS;
+    int playoutResyncSeq = PLAYOUT_RESYNC_SEQ;
+    unsigned long playoutResyncMs = PLAYOUT_RESYNC_MS;
+    unsigned long receiverStatsMs = RECEIVER_STATS_MS;
+    
     // 功能开关
     bool enableEspNow = ENABLE_ESPNOW;
     bool autoSetBase = AUTO_SET_BASE;
-    bool debugModePlotter = DEBUG_MODE_PLOTTER;
-    bool debugModeSimple = DEBUG_MODE_SIMPLE;
-    bool debugModeAlpha = DEBUG_MODE_ALPHA;
+    bool warmStartEnable = WARM_START_ENABLE;
+    bool idlePowerEnable = IDLE_POWER_ENABLE;
+    bool enableGestures = ENABLE_GESTURES;
+    bool enableGestureRadio = ENABLE_GESTURE_RADIO;
+    bool enableStateSeq = ENABLE_STATE_SEQ;
+    bool enableSpectralNotch = ENABLE_SPECTRAL_NOTCH;
+    bool enableResponseCurve = ENABLE_RESPONSE_CURVE;
+    bool enableShadowPipeline = ENABLE_SHADOW_PIPELINE;
+    bool enableTelemetry = ENABLE_TELEMETRY;
+    bool enableOutputQuantizer = ENABLE_OUTPUT_QUANTIZER;
+    bool enableResourceMonitor = ENABLE_RESOURCE_MONITOR;
 };
 
 // 全局配置实例
@@ -7,6 +7,12 @@
 #include "config.h"
 #include "ThereminEngine.h"
 #include "DisplayController.h"
+#include "DiagnosticView.h"
+#include "GestureDetector.h"
+#include "ShadowPipeline.h"
+#include "Telemetry.h"
+#include "ResourceMonitor.h"
+#include "RadioProtocol.h"
 
 // ========================================================
 // ======= ESP-NOW 配置 ================================
@@ -15,16 +21,12 @@
 uint8_t broadcastAddress[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
 #if ENABLE_ESPNOW
-typedef struct __attribute__((packed)) struct_message {
-    int a;
-    int b;
-    int c;
-} struct_message;
-
-struct_message sharedData;
+state_message sharedData;
 volatile bool newDataReady = false;
 volatile bool espNowTaskRunning = false;
+volatile bool espNowPaused = false;      // 空闲时暂停发送并降低轮询频率
 TaskHandle_t espNowTaskHandle = NULL;
+QueueHandle_t gestureQueue = NULL;       // 手势事件不受节流限制，排队发送
 portMUX_TYPE dataMux = portMUX_INITIALIZER_UNLOCKED;
 static unsigned long lastEspNowSend = 0;
 
@@ -45,37 +47,61 @@ bool setupESPNow() {
 }
 
 void sendESPNowData(int looking, int duty, int direction) {
-    struct_message tempData = {looking, duty, direction};
+    state_message tempData = {looking, duty, direction, 0, (uint32_t)millis()};
     
     portENTER_CRITICAL(&dataMux);
-    memcpy(&sharedData, &tempData, sizeof(struct_message));
+    memcpy(&sharedData, &tempData, sizeof(state_message));
     newDataReady = true;
     portEXIT_CRITICAL(&dataMux);
 }
 
+void sendESPNowGesture(const GestureEvent& ev) {
+    static uint16_t gestureSeq = 0;
+    if (!gestureQueue) return;
+    gesture_message msg;
+    msg.magic = GESTURE_MSG_MAGIC;
+    msg.version = GESTURE_MSG_VERSION;
+    msg.type = ev.type;
+    msg.seq = gestureSeq++;
+    msg.direction = ev.direction;
+    msg.timestampMs = ev.timestampMs;
+    msg.durationMs = (uint16_t)min(ev.durationMs, 65535UL);
+    msg.peakDeltaX10 = (uint16_t)constrain(ev.peakDelta * 10.0f, 0.0f, 65535.0f);
+    xQueueSend(gestureQueue, &msg, 0);  // 队列满时丢弃，不阻塞主循环
+}
+
 void espNowTask(void* pvParameters) {
     espNowTaskRunning = true;
-    struct_message localData = {0, 0, 0};
+    state_message localData = {0, 0, 0, 0, 0};
+    uint16_t seq = 0;
     int lastA = -1, lastB = -1;
+    gesture_message gestureMsg;
     
     while (espNowTaskRunning) {
+        while (gestureQueue && xQueueReceive(gestureQueue, &gestureMsg, 0) == pdTRUE) {
+            esp_now_send(broadcastAddress, (uint8_t*)&gestureMsg, sizeof(gestureMsg));
+        }
+        
         if (newDataReady) {
             portENTER_CRITICAL(&dataMux);
-            memcpy(&localData, &sharedData, sizeof(struct_message));
+            memcpy(&localData, &sharedData, sizeof(state_message));
             newDataReady = false;
             portEXIT_CRITICAL(&dataMux);
             
             // 10ms 节流
             if (millis() - lastEspNowSend > 10) {
                 if (localData.a != lastA || localData.b != lastB) {
-                    esp_now_send(broadcastAddress, (uint8_t*)&localData, sizeof(localData));
+                    localData.seq = seq++;
+                    // 未开启序号时只发送前12字节 (struct_message)，兼容旧接收端
+                    esp_now_send(broadcastAddress, (uint8_t*)&localData,
+                                 config.enableStateSeq ? sizeof(state_message) : sizeof(struct_message));
                     lastA = localData.a;
                     lastB = localData.b;
                     lastEspNowSend = millis();
                 }
             }
         }
-        vTaskDelay(pdMS_TO_TICKS(1));
+        vTaskDelay(pdMS_TO_TICKS(espNowPaused ? config.idleEspNowPollMs : 1));
     }
     vTaskDelete(NULL);
 }
@@ -87,12 +113,22 @@ void espNowTask(void* pvParameters) {
 
 ThereminEngine engine;
 DisplayController display;
+DiagnosticView view(display);
+GestureDetector gestures;
+
+#if ENABLE_SHADOW_PIPELINE
+ThereminConfig shadowConfig;
+ShadowPipeline shadow(shadowConfig);
+#endif
 
 // ========================================================
 // ======= 函数声明 ================================
 // ========================================================
 
 void blinkAnimation();
+void onGesture(const GestureEvent& ev);
+void setupShadowConfig();
+void handleSerialCommands();
 
 // ========================================================
 // ======= 眨眼动画 ================================
@@ -109,6 +145,63 @@ void blinkAnimation() {
     }
 }
 
+// ========================================================
+// ======= 手势事件 ================================
+// ========================================================
+
+void onGesture(const GestureEvent& ev) {
+    if (!telemetry.isEnabled()) {
+        Serial.printf("GESTURE: %s t=%lu dur=%lu peak=%.1f\n",
+                      gestures.typeName(ev.type), ev.timestampMs, ev.durationMs, ev.peakDelta);
+    }
+    #if ENABLE_ESPNOW
+    sendESPNowGesture(ev);
+    #endif
+}
+
+// ========================================================
+// ======= 影子管线 (A/B调参) ======================
+// ========================================================
+
+// 以主配置为基础，只覆盖要对比的参数
+void setupShadowConfig() {
+    #if ENABLE_SHADOW_PIPELINE
+    shadowConfig = config;
+    shadowConfig.alphaDeltaBase = 0.3f;       // 示例: 更强的delta平滑
+    shadowConfig.handFactorThreshold = 4.0f;  // 示例: 更晚锁定基线
+    #endif
+}
+
+// ========================================================
+// ======= 串口命令 ================================
+// ========================================================
+
+// 每行一条命令:
+//   T<hex>  设置遥测字段掩码 (见 Telemetry.h)，例如 T7F；T0 关闭遥测
+//   V[0|1]  诊断滚动视图开关 (无参数时切换)
+void handleSerialCommands() {
+    static char line[16];
+    static int len = 0;
+    
+    while (Serial.available()) {
+        char ch = (char)Serial.read();
+        if (ch == '\r') continue;
+        if (ch != '\n') {
+            if (len < (int)sizeof(line) - 1) line[len++] = ch;
+            continue;
+        }
+        line[len] = '\0';
+        len = 0;
+        
+        if (line[0] == 'T') {
+            telemetry.setFieldMask(strtoul(line + 1, NULL, 16));
+        } else if (line[0] == 'V') {
+            bool enable = line[1] ? line[1] != '0' : !view.isEnabled();
+            view.setEnabled(enable, engine.getFrozenBaseFreq());
+        }
+    }
+}
+
 // ========================================================
 // ======= 主函数 ================================
 // ========================================================
@@ -121,40 +214,113 @@ void setup() {
     
     Serial.println("=== ESP32 Theremin v3.4 ===");
     
+    resources.begin();
+    resources.registerTask(NULL, "loopTask", getArduinoLoopTaskStackSize());
+    
     if (!display.begin()) Serial.println("ERROR: Display failed");
     if (!engine.begin()) Serial.println("ERROR: Engine failed");
+    if (engine.getStorageTaskHandle()) {
+        resources.registerTask(engine.getStorageTaskHandle(), "NvsTask", config.snapshotNvsTaskStack);
+    }
+    if (engine.getSpectrumTaskHandle()) {
+        resources.registerTask(engine.getSpectrumTaskHandle(), "SpectrumTask", config.spectrumTaskStack);
+    }
+    if (config.enableTelemetry) {
+        if (!telemetry.begin()) Serial.println("ERROR: Telemetry failed");
+        else resources.registerTask(telemetry.getTaskHandle(), "TelemetryTask", config.telemetryTaskStack);
+    }
+    
+    gestures.setCallback(onGesture);
+    
+    #if ENABLE_SHADOW_PIPELINE
+    setupShadowConfig();
+    if (!shadow.begin(engine)) Serial.println("ERROR: Shadow pipeline failed");
+    else resources.registerTask(shadow.getTaskHandle(), "ShadowTask", config.shadowTaskStack);
+    #endif
     
     #if ENABLE_ESPNOW
+    if (config.enableGestureRadio) gestureQueue = xQueueCreate(8, sizeof(gesture_message));
     if (!setupESPNow()) {
         Serial.println("ERROR: ESP-NOW failed");
     } else {
-        xTaskCreatePinnedToCore(espNowTask, "ESPNowTask", 2048, NULL, 2, &espNowTaskHandle, 1);
+        xTaskCreatePinnedToCore(espNowTask, "ESPNowTask", config.espNowTaskStack, NULL, 2, &espNowTaskHandle, 1);
+        resources.registerTask(espNowTaskHandle, "ESPNowTask", config.espNowTaskStack);
     }
     #endif
     
     Serial.println("System Initialized");
+    resources.markInitDone();
 }
 
 void loop() {
-    engine.process();
+    handleSerialCommands();
+    
+    bool newSample = engine.process();
+    engine.runSpectralAnalysis();       // 分析任务未启动时的回退 (有任务时直接返回)
+    
+    #if ENABLE_SHADOW_PIPELINE
+    if (newSample) shadow.submit(engine, millis());
+    #endif
+    
+    // ===== 手势识别 (每样本一次，基线建立前 delta 无意义) =====
+    if (newSample && config.enableGestures && engine.isBaselineSet()) {
+        gestures.update(millis(), engine.getSmoothedDelta(), engine.getDirection());
+    }
+    
+    // ===== 空闲省电 =====
+    static bool wasIdle = false;
+    bool idle = engine.isIdle();
+    if (idle != wasIdle) {
+        display.setPowerSave(idle);
+        #if ENABLE_ESPNOW
+        espNowPaused = idle;
+        #endif
+        wasIdle = idle;
+    }
+    if (idle) {
+        vTaskDelay(pdMS_TO_TICKS(config.idleLoopDelayMs));
+        return;
+    }
     
     int currentLooking = engine.getLooking();
-    display.updateEyes(currentLooking);
+    if (view.isEnabled()) {
+        view.update(millis(), engine.getSmoothedDelta(), engine.getFrozenBaseFreq(),
+                    engine.isEnvironmentalJitter());
+    } else {
+        display.updateEyes(currentLooking);
+    }
     
-    // 调试打印
+    // 调试打印 (遥测开启时保持串口为纯二进制流)
     static int lastPrint = 0;
-    if (millis() - lastPrint > 500) {
-        Serial.print("Looking: ");
-        Serial.println(currentLooking);
+    if (!telemetry.isEnabled() && millis() - lastPrint > 500) {
+        const QuantizerStats& q = engine.getQuantizerStats();
+        Serial.printf("Looking: %d | quant L %lu/%lu D %lu/%lu\n", currentLooking,
+                      (unsigned long)q.lookingEmitted, (unsigned long)q.lookingSuppressed,
+                      (unsigned long)q.dutyEmitted, (unsigned long)q.dutySuppressed);
         lastPrint = millis();
     }
     
+    // 资源报告
+    static unsigned long lastResourceReport = 0;
+    if (config.enableResourceMonitor && !telemetry.isEnabled() &&
+        millis() - lastResourceReport > config.resourceReportMs) {
+        resources.printReport();
+        lastResourceReport = millis();
+    }
+    
+    // 诊断视图帧率/渲染耗时
+    static unsigned long lastViewStats = 0;
+    if (view.isEnabled() && !telemetry.isEnabled() && millis() - lastViewStats > 5000) {
+        view.printStats();
+        lastViewStats = millis();
+    }
+    
     // 随机眨眼 - 500ms冷却，5%概率
     static unsigned long lastBlinkTime = 0;
-    if (currentLooking == 0) {
+    if (currentLooking == 0 && !view.isEnabled()) {
         if (millis() - lastBlinkTime > 500) {
             if (random(1, 20) == 1) {
-                Serial.println("BLINK!");
+                if (!telemetry.isEnabled()) Serial.println("BLINK!");
                 blinkAnimation();
                 lastBlinkTime = millis();
             }
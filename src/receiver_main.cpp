@@ -0,0 +1,129 @@
+// 接收端固件 (pio run -e receiver)
+// 接收发送端广播的 ESP-NOW 状态，经抖动缓冲按稳定播放时钟驱动远端眼睛显示
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <SPI.h>
+
+#include "config.h"
+#include "DisplayController.h"
+#include "GestureDetector.h"
+#include "JitterBuffer.h"
+#include "RadioProtocol.h"
+
+// ========================================================
+// ======= 全局对象 ================================
+// ========================================================
+
+// 接收端不链接 ThereminEngine.cpp，全局配置在此定义
+ThereminConfig config;
+
+DisplayController display;
+JitterBuffer jitterBuffer;
+portMUX_TYPE bufferMux = portMUX_INITIALIZER_UNLOCKED;
+
+// 旧版12字节消息无序号与时间戳: 本地编号并以到达时刻作为发送时刻
+static uint16_t legacySeq = 0;
+
+// ========================================================
+// ======= ESP-NOW 接收 ============================
+// ========================================================
+
+// 运行在 WiFi 任务中，只做解析与入队
+void onDataRecv(const esp_now_recv_info_t* info, const uint8_t* data, int len) {
+    unsigned long now = millis();
+    PlayoutSample sample;
+
+    if (len == sizeof(state_message)) {
+        state_message msg;
+        memcpy(&msg, data, sizeof(msg));
+        sample.seq = msg.seq;
+        sample.senderMs = msg.timestampMs;
+        sample.looking = msg.a;
+        sample.duty = msg.b;
+        sample.direction = msg.c;
+    } else if (len == sizeof(struct_message)) {
+        struct_message msg;
+        memcpy(&msg, data, sizeof(msg));
+        sample.seq = legacySeq++;
+        sample.senderMs = now;
+        sample.looking = msg.a;
+        sample.duty = msg.b;
+        sample.direction = msg.c;
+    } else if (isGestureMessage(data, len)) {
+        gesture_message msg;
+        memcpy(&msg, data, sizeof(msg));
+        Serial.printf("GESTURE: %s t=%lu dur=%u\n", GestureDetector::typeName((GestureType)msg.type),
+                      (unsigned long)msg.timestampMs, msg.durationMs);
+        return;
+    } else {
+        return;
+    }
+
+    sample.looking = constrain(sample.looking, 0, 8);
+    portENTER_CRITICAL(&bufferMux);
+    jitterBuffer.push(sample, now);
+    portEXIT_CRITICAL(&bufferMux);
+}
+
+bool setupESPNow() {
+    WiFi.mode(WIFI_STA);
+    WiFi.disconnect();
+    esp_wifi_set_channel(1, WIFI_SECOND_CHAN_NONE);  // 与发送端 peer 信道一致
+    if (esp_now_init() != ESP_OK) return false;
+    return esp_now_register_recv_cb(onDataRecv) == ESP_OK;
+}
+
+// ========================================================
+// ======= 统计输出 ================================
+// ========================================================
+
+void printStats() {
+    portENTER_CRITICAL(&bufferMux);
+    JitterStats st = jitterBuffer.getStats();
+    portEXIT_CRITICAL(&bufferMux);
+
+    Serial.printf("RX n:%lu late:%lu dup:%lu ovf:%lu lost:%lu rs:%lu conc:%lu/%lu chg:%lu jump:%lu jit:%.1fms delay:%.1fms\n",
+                  (unsigned long)st.received, (unsigned long)st.late, (unsigned long)st.duplicates,
+                  (unsigned long)st.overflow, (unsigned long)st.lost, (unsigned long)st.resyncs,
+                  (unsigned long)st.concealedTicks, (unsigned long)st.ticks,
+                  (unsigned long)st.lookingChanges, (unsigned long)st.lookingJumps,
+                  st.jitterMs, st.delayMs);
+}
+
+// ========================================================
+// ======= 主函数 ================================
+// ========================================================
+
+void setup() {
+    Serial.begin(115200);
+    delay(100);
+
+    Serial.println("=== ESP32 Theremin Receiver ===");
+
+    if (!display.begin()) Serial.println("ERROR: Display failed");
+    if (!setupESPNow()) Serial.println("ERROR: ESP-NOW failed");
+
+    Serial.println("System Initialized");
+}
+
+// 播放时钟: 固定周期取一帧，与包到达时刻解耦
+void loop() {
+    static TickType_t lastWake = xTaskGetTickCount();
+    static unsigned long lastStats = 0;
+
+    PlayoutFrame frame;
+    portENTER_CRITICAL(&bufferMux);
+    bool ready = jitterBuffer.playout(millis(), frame);
+    portEXIT_CRITICAL(&bufferMux);
+
+    if (ready) display.updateEyes(frame.looking);
+
+    if (millis() - lastStats >= config.receiverStatsMs) {
+        printStats();
+        lastStats = millis();
+    }
+
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(config.playoutPeriodMs));
+}
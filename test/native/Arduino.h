@@ -0,0 +1,253 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// ========================================================
+// ======= 主机端 Arduino 替身 (native 测试环境) =========
+// ========================================================
+
+// 仅供 [env:native] 使用: 让 src/ 中的纯计算模块与硬件初始化路径在 PC 上编译运行。
+// 全部为内联定义，无需额外的翻译单元；仿真状态集中在 host 命名空间，由测试直接控制:
+//   - millis() 为可控的假时钟 (host::advanceMs)，micros() 为真实单调时钟 (用于计时)
+//   - 定时器/按键中断由测试触发 (host::fireTimer / host::setPin)
+//   - Serial 输出到 stdout，可静音并统计行数
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
+
+#define LOW     0
+#define HIGH    1
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define INPUT_PULLUP    0x05
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+typedef int esp_err_t;
+#define ESP_OK              0
+#define ESP_FAIL            -1
+#define ESP_ERR_TIMEOUT     0x107
+
+template <class T, class L, class H>
+inline T constrain(T x, L lo, H hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// ========================================================
+// ======= 仿真状态 (Host Simulation) ====================
+// ========================================================
+
+namespace host {
+    constexpr int PIN_COUNT = 64;
+
+    inline unsigned long nowMs = 0;
+
+    inline int pinLevel[PIN_COUNT] = {};
+    inline void (*pinIsr[PIN_COUNT])() = {};
+    inline int pinIsrMode[PIN_COUNT] = {};
+
+    inline void (*timerIsr)() = nullptr;
+    inline uint64_t timerPeriodUs = 0;
+    inline bool timerRunning = false;
+
+    inline uint32_t ledcDuty[PIN_COUNT] = {};
+
+    inline bool serialMuted = false;
+    inline uint32_t serialLines = 0;        // printf/println 行数 (含静音时)
+    inline size_t serialBinaryBytes = 0;    // Serial.write 字节数
+
+    inline void advanceMs(unsigned long ms) { nowMs += ms; }
+
+    // 改变引脚电平，满足边沿条件时调用已挂接的中断
+    inline void setPin(int pin, int level) {
+        int old = pinLevel[pin];
+        pinLevel[pin] = level;
+        if (!pinIsr[pin] || old == level) return;
+        int mode = pinIsrMode[pin];
+        if (mode == CHANGE || (mode == FALLING && level == LOW) || (mode == RISING && level == HIGH)) {
+            pinIsr[pin]();
+        }
+    }
+
+    inline void fireTimer() {
+        if (timerRunning && timerIsr) timerIsr();
+    }
+
+    inline void reset() {
+        nowMs = 0;
+        for (int i = 0; i < PIN_COUNT; i++) {
+            pinLevel[i] = HIGH;
+            pinIsr[i] = nullptr;
+            ledcDuty[i] = 0;
+        }
+        timerIsr = nullptr;
+        timerPeriodUs = 0;
+        timerRunning = false;
+        serialLines = 0;
+        serialBinaryBytes = 0;
+    }
+}
+
+// ========================================================
+// ======= 时间 ==========================================
+// ========================================================
+
+inline unsigned long millis() { return host::nowMs; }
+
+inline unsigned long micros() {
+    using namespace std::chrono;
+    return (unsigned long)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+inline void delay(unsigned long ms) { host::nowMs += ms; }
+inline void delayMicroseconds(unsigned int) {}
+inline void yield() {}
+
+// ========================================================
+// ======= GPIO / 中断 ===================================
+// ========================================================
+
+inline void pinMode(int pin, int mode) {
+    if (mode == INPUT_PULLUP) host::pinLevel[pin] = HIGH;
+}
+inline int digitalRead(int pin) { return host::pinLevel[pin]; }
+inline void digitalWrite(int pin, int level) { host::pinLevel[pin] = level; }
+
+inline void attachInterrupt(int pin, void (*isr)(), int mode) {
+    host::pinIsr[pin] = isr;
+    host::pinIsrMode[pin] = mode;
+}
+inline void detachInterrupt(int pin) { host::pinIsr[pin] = nullptr; }
+
+// ========================================================
+// ======= 硬件定时器 / LEDC =============================
+// ========================================================
+
+struct hw_timer_s { int id; };
+typedef struct hw_timer_s hw_timer_t;
+
+inline hw_timer_t* timerBegin(uint32_t) {
+    static hw_timer_t timer = {0};
+    return &timer;
+}
+inline void timerAttachInterrupt(hw_timer_t*, void (*isr)()) { host::timerIsr = isr; }
+inline void timerAlarm(hw_timer_t*, uint64_t alarmUs, bool, uint64_t) { host::timerPeriodUs = alarmUs; }
+inline void timerStart(hw_timer_t*) { host::timerRunning = true; }
+inline void timerStop(hw_timer_t*) { host::timerRunning = false; }
+inline void timerWrite(hw_timer_t*, uint64_t) {}
+
+inline bool ledcAttach(int, uint32_t, uint8_t) { return true; }
+inline bool ledcWrite(int pin, uint32_t duty) {
+    host::ledcDuty[pin] = duty;
+    return true;
+}
+
+// ========================================================
+// ======= FreeRTOS (单线程替身) =========================
+// ========================================================
+
+// 主机测试不运行调度器: 任务创建失败，调用方走离线路径；临界区为空操作
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void* TaskHandle_t;
+typedef void* QueueHandle_t;
+typedef int portMUX_TYPE;
+
+#define pdTRUE      1
+#define pdFALSE     0
+#define pdPASS      1
+#define pdFAIL      0
+#define portMAX_DELAY 0xffffffffUL
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux)     ((void)(mux))
+#define portEXIT_CRITICAL(mux)      ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux)  ((void)(mux))
+
+inline BaseType_t xTaskCreatePinnedToCore(void (*)(void*), const char*, uint32_t, void*,
+                                          UBaseType_t, TaskHandle_t* handle, BaseType_t) {
+    if (handle) *handle = nullptr;
+    return pdFAIL;
+}
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return nullptr; }
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 0; }
+inline TickType_t xTaskGetTickCount() { return (TickType_t)host::nowMs; }
+inline void vTaskDelay(TickType_t ticks) { host::nowMs += ticks; }
+inline void vTaskDelayUntil(TickType_t* last, TickType_t period) {
+    *last += period;
+    if (host::nowMs < *last) host::nowMs = *last;
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+inline BaseType_t xTaskNotifyGive(TaskHandle_t) { return pdPASS; }
+
+inline QueueHandle_t xQueueCreate(UBaseType_t, UBaseType_t) { return nullptr; }
+inline BaseType_t xQueueSend(QueueHandle_t, const void*, TickType_t) { return pdFALSE; }
+inline BaseType_t xQueueReceive(QueueHandle_t, void*, TickType_t) { return pdFALSE; }
+
+// ========================================================
+// ======= Serial ========================================
+// ========================================================
+
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    void flush() { fflush(stdout); }
+    int available() { return 0; }
+    int read() { return -1; }
+    int availableForWrite() { return 4096; }
+
+    size_t write(const uint8_t* data, size_t len) {
+        (void)data;
+        host::serialBinaryBytes += len;
+        return len;
+    }
+
+    int printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        if (strchr(fmt, '\n')) host::serialLines++;
+        if (host::serialMuted) return 0;
+        va_list args;
+        va_start(args, fmt);
+        int n = vprintf(fmt, args);
+        va_end(args);
+        return n;
+    }
+
+    void print(const char* s) { if (!host::serialMuted) fputs(s, stdout); }
+    void print(int v) { if (!host::serialMuted) ::printf("%d", v); }
+    void print(float v) { if (!host::serialMuted) ::printf("%.2f", v); }
+    void println() { line(""); }
+    void println(const char* s) { line(s); }
+    void println(int v) { char buf[16]; snprintf(buf, sizeof(buf), "%d", v); line(buf); }
+    void println(float v) { char buf[32]; snprintf(buf, sizeof(buf), "%.2f", v); line(buf); }
+
+private:
+    void line(const char* s) {
+        host::serialLines++;
+        if (!host::serialMuted) puts(s);
+    }
+};
+
+inline HardwareSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,75 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+// ========================================================
+// ======= 主机端 NVS 替身 ===============================
+// ========================================================
+
+// 内存中的键值存储，跨 Preferences 实例共享 (模拟 flash 中的同一分区)
+// host::nvsWrites 统计 putBytes 次数，用于验证写入频率与写入时机
+// host::nvsFailWrites > 0 时接下来的若干次 putBytes 失败 (模拟 flash 写入错误)
+namespace host {
+    inline std::map<std::string, std::vector<uint8_t>> nvs;
+    inline uint32_t nvsWrites = 0;
+    inline uint32_t nvsFailWrites = 0;
+    inline bool nvsAvailable = true;
+
+    inline void resetNvs() {
+        nvs.clear();
+        nvsWrites = 0;
+        nvsFailWrites = 0;
+        nvsAvailable = true;
+    }
+}
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) {
+        m_ns = name;
+        m_readOnly = readOnly;
+        m_open = host::nvsAvailable;
+        return m_open;
+    }
+
+    void end() { m_open = false; }
+
+    size_t putBytes(const char* key, const void* value, size_t len) {
+        if (!m_open || m_readOnly) return 0;
+        if (host::nvsFailWrites > 0) {
+            host::nvsFailWrites--;
+            return 0;
+        }
+        const uint8_t* p = (const uint8_t*)value;
+        host::nvs[m_ns + "/" + key].assign(p, p + len);
+        host::nvsWrites++;
+        return len;
+    }
+
+    size_t getBytesLength(const char* key) {
+        auto it = host::nvs.find(m_ns + "/" + key);
+        return (m_open && it != host::nvs.end()) ? it->second.size() : 0;
+    }
+
+    size_t getBytes(const char* key, void* buf, size_t maxLen) {
+        auto it = host::nvs.find(m_ns + "/" + key);
+        if (!m_open || it == host::nvs.end() || it->second.size() > maxLen) return 0;
+        memcpy(buf, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+
+    bool remove(const char* key) {
+        return m_open && !m_readOnly && host::nvs.erase(m_ns + "/" + key) > 0;
+    }
+
+private:
+    std::string m_ns;
+    bool m_readOnly = false;
+    bool m_open = false;
+};
+
+#endif // HOST_PREFERENCES_H
@@ -0,0 +1,60 @@
+#ifndef HOST_PULSE_CNT_H
+#define HOST_PULSE_CNT_H
+
+#include "Arduino.h"
+
+// ========================================================
+// ======= 主机端 PCNT 替身 ==============================
+// ========================================================
+
+// 单个计数单元: 测试写入 host::pcntCount 后调用 host::fireTimer() 模拟一个采样周期
+// 计数按单元上下限饱和 (真实硬件在上限处回绕/触发事件，两者都会丢失计数)
+namespace host {
+    inline int pcntCount = 0;
+    inline int pcntHighLimit = 0;
+    inline uint32_t pcntOverflows = 0;      // 写入值超出上限的次数
+}
+
+typedef struct { int low_limit; int high_limit; } pcnt_unit_config_t;
+typedef struct { uint32_t max_glitch_ns; } pcnt_glitch_filter_config_t;
+typedef struct { int edge_gpio_num; int level_gpio_num; } pcnt_chan_config_t;
+typedef struct pcnt_unit_s* pcnt_unit_handle_t;
+typedef struct pcnt_chan_s* pcnt_channel_handle_t;
+
+typedef enum {
+    PCNT_CHANNEL_EDGE_ACTION_HOLD,
+    PCNT_CHANNEL_EDGE_ACTION_INCREASE,
+    PCNT_CHANNEL_EDGE_ACTION_DECREASE,
+} pcnt_channel_edge_action_t;
+
+inline esp_err_t pcnt_new_unit(const pcnt_unit_config_t* config, pcnt_unit_handle_t* ret) {
+    static int unit;
+    host::pcntHighLimit = config->high_limit;
+    *ret = (pcnt_unit_handle_t)&unit;
+    return ESP_OK;
+}
+inline esp_err_t pcnt_unit_set_glitch_filter(pcnt_unit_handle_t, const pcnt_glitch_filter_config_t*) { return ESP_OK; }
+inline esp_err_t pcnt_new_channel(pcnt_unit_handle_t, const pcnt_chan_config_t*, pcnt_channel_handle_t* ret) {
+    static int channel;
+    *ret = (pcnt_channel_handle_t)&channel;
+    return ESP_OK;
+}
+inline esp_err_t pcnt_channel_set_edge_action(pcnt_channel_handle_t, pcnt_channel_edge_action_t,
+                                              pcnt_channel_edge_action_t) { return ESP_OK; }
+inline esp_err_t pcnt_unit_enable(pcnt_unit_handle_t) { return ESP_OK; }
+inline esp_err_t pcnt_unit_start(pcnt_unit_handle_t) { return ESP_OK; }
+inline esp_err_t pcnt_unit_clear_count(pcnt_unit_handle_t) {
+    host::pcntCount = 0;
+    return ESP_OK;
+}
+inline esp_err_t pcnt_unit_get_count(pcnt_unit_handle_t, int* value) {
+    if (host::pcntHighLimit && host::pcntCount > host::pcntHighLimit) {
+        host::pcntOverflows++;
+        *value = host::pcntHighLimit;
+    } else {
+        *value = host::pcntCount;
+    }
+    return ESP_OK;
+}
+
+#endif // HOST_PULSE_CNT_H
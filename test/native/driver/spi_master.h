@@ -0,0 +1,137 @@
+#ifndef HOST_SPI_MASTER_H
+#define HOST_SPI_MASTER_H
+
+#include <deque>
+#include "Arduino.h"
+
+// ========================================================
+// ======= 主机端 SPI 主机 + MAX7219 链仿真 ==============
+// ========================================================
+
+// 每个 SPI 主机挂一条 MAX7219 菊花链。每次 CS 周期 (一个事务) 的数据按移位寄存器语义解码:
+// 先移出的 2 字节最终停在离 MCU 最远的模块，因此事务中第 k 个字节对 (k 从 0 起)
+// 属于模块 (链长 - 1 - k)。解码后的行/寄存器状态供测试逐位校验。
+// 线上时间按 bits / clock_speed_hz 累计 (不含 CS 间隙)，即 DMA 传输的理论下限。
+
+typedef enum { SPI1_HOST = 0, SPI2_HOST = 1, SPI3_HOST = 2, SPI_HOST_MAX = 3 } spi_host_device_t;
+
+#define SPI_DMA_CH_AUTO 3
+
+typedef struct {
+    int mosi_io_num;
+    int miso_io_num;
+    int sclk_io_num;
+    int quadwp_io_num;
+    int quadhd_io_num;
+    int max_transfer_sz;
+} spi_bus_config_t;
+
+typedef struct {
+    uint8_t mode;
+    int clock_speed_hz;
+    int spics_io_num;
+    int queue_size;
+} spi_device_interface_config_t;
+
+typedef struct {
+    size_t length;                  // 位数
+    const void* tx_buffer;
+    void* rx_buffer;
+} spi_transaction_t;
+
+namespace host {
+    constexpr int MAX7219_MODULES = 64;
+
+    struct Max7219Module {
+        uint8_t rows[8];
+        uint8_t intensity;
+        uint8_t shutdown;           // 寄存器值: 0 = 关断, 1 = 正常
+    };
+
+    struct SpiDevice {
+        bool used = false;
+        int clockHz = 0;
+        int queueSize = 0;
+        std::deque<spi_transaction_t*> inFlight;
+
+        // 统计 (resetSpiStats 清零)
+        uint32_t transactions = 0;
+        size_t bytes = 0;
+        double wireUs = 0;
+
+        // 链状态
+        int modules = 0;
+        Max7219Module chain[MAX7219_MODULES] = {};
+    };
+
+    inline SpiDevice spi[SPI_HOST_MAX];
+    inline int spiQueueBudget = -1;     // 剩余可成功排队的事务数 (-1 = 不限)，用于注入队列失败
+
+    inline void resetSpi() {
+        for (auto& d : spi) d = SpiDevice();
+        spiQueueBudget = -1;
+    }
+
+    inline void resetSpiStats() {
+        for (auto& d : spi) {
+            d.transactions = 0;
+            d.bytes = 0;
+            d.wireUs = 0;
+        }
+    }
+
+    inline void spiDeliver(SpiDevice& d, const spi_transaction_t* t) {
+        const uint8_t* tx = (const uint8_t*)t->tx_buffer;
+        size_t len = t->length / 8;
+        int modules = (int)(len / 2);
+        d.modules = modules;
+        d.transactions++;
+        d.bytes += len;
+        d.wireUs += t->length * 1e6 / d.clockHz;
+
+        for (int k = 0; k < modules && k < MAX7219_MODULES; k++) {
+            Max7219Module& m = d.chain[modules - 1 - k];
+            uint8_t reg = tx[2 * k], value = tx[2 * k + 1];
+            if (reg >= 0x01 && reg <= 0x08) m.rows[reg - 1] = value;
+            else if (reg == 0x0A) m.intensity = value;
+            else if (reg == 0x0C) m.shutdown = value;
+        }
+    }
+}
+
+typedef host::SpiDevice* spi_device_handle_t;
+
+inline esp_err_t spi_bus_initialize(spi_host_device_t, const spi_bus_config_t*, int) { return ESP_OK; }
+
+inline esp_err_t spi_bus_add_device(spi_host_device_t host_id, const spi_device_interface_config_t* cfg,
+                                    spi_device_handle_t* handle) {
+    host::SpiDevice& d = host::spi[host_id];
+    d = host::SpiDevice();
+    d.used = true;
+    d.clockHz = cfg->clock_speed_hz;
+    d.queueSize = cfg->queue_size;
+    *handle = &d;
+    return ESP_OK;
+}
+
+inline esp_err_t spi_device_polling_transmit(spi_device_handle_t d, spi_transaction_t* t) {
+    host::spiDeliver(*d, t);
+    return ESP_OK;
+}
+
+inline esp_err_t spi_device_queue_trans(spi_device_handle_t d, spi_transaction_t* t, TickType_t) {
+    if ((int)d->inFlight.size() >= d->queueSize || host::spiQueueBudget == 0) return ESP_ERR_TIMEOUT;
+    if (host::spiQueueBudget > 0) host::spiQueueBudget--;
+    d->inFlight.push_back(t);
+    return ESP_OK;
+}
+
+inline esp_err_t spi_device_get_trans_result(spi_device_handle_t d, spi_transaction_t** t, TickType_t) {
+    if (d->inFlight.empty()) return ESP_ERR_TIMEOUT;
+    *t = d->inFlight.front();
+    d->inFlight.pop_front();
+    host::spiDeliver(*d, *t);
+    return ESP_OK;
+}
+
+#endif // HOST_SPI_MASTER_H
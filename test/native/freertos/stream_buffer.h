@@ -0,0 +1,37 @@
+#ifndef HOST_STREAM_BUFFER_H
+#define HOST_STREAM_BUFFER_H
+
+#include <deque>
+#include "Arduino.h"
+
+// ========================================================
+// ======= 主机端 StreamBuffer 替身 ======================
+// ========================================================
+
+// 单线程字节队列，容量语义与 FreeRTOS 一致 (满时按可用空间截断)
+struct HostStreamBuffer {
+    std::deque<uint8_t> bytes;
+    size_t capacity;
+};
+typedef HostStreamBuffer* StreamBufferHandle_t;
+
+inline StreamBufferHandle_t xStreamBufferCreate(size_t size, size_t) {
+    return new HostStreamBuffer{{}, size};
+}
+inline size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t sb) {
+    return sb->capacity - sb->bytes.size();
+}
+inline size_t xStreamBufferSend(StreamBufferHandle_t sb, const void* data, size_t len, TickType_t) {
+    len = min(len, xStreamBufferSpacesAvailable(sb));
+    const uint8_t* p = (const uint8_t*)data;
+    sb->bytes.insert(sb->bytes.end(), p, p + len);
+    return len;
+}
+inline size_t xStreamBufferReceive(StreamBufferHandle_t sb, void* data, size_t len, TickType_t) {
+    len = min(len, sb->bytes.size());
+    std::copy(sb->bytes.begin(), sb->bytes.begin() + len, (uint8_t*)data);
+    sb->bytes.erase(sb->bytes.begin(), sb->bytes.begin() + len);
+    return len;
+}
+
+#endif // HOST_STREAM_BUFFER_H
@@ -0,0 +1,47 @@
+#ifndef HOST_TEST_SUPPORT_H
+#define HOST_TEST_SUPPORT_H
+
+#include <unity.h>
+#include "ThereminEngine.h"
+
+// ========================================================
+// ======= 主机端测试公用 (各 test_* 共享) ===============
+// ========================================================
+
+namespace host {
+    // 确定性伪随机 (LCG)，保证各平台结果可复现；beginTest() 置为 1，用例可另设种子
+    inline uint32_t seed = 1;
+
+    // 24 位均匀随机数
+    inline uint32_t random24() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    }
+
+    // [-amplitude, amplitude) 均匀噪声
+    inline float noise(float amplitude) {
+        return (random24() / 16777216.0f - 0.5f) * 2.0f * amplitude;
+    }
+
+    // 用例开始: 时钟/引脚/NVS/PCNT 复位，串口静音，随机种子与配置恢复默认
+    inline void beginTest(ThereminConfig& cfg) {
+        reset();
+        resetNvs();
+        pcntOverflows = 0;
+        serialMuted = true;
+        seed = 1;
+        cfg = ThereminConfig();
+    }
+
+    // 一个采样周期: 按当前定时器周期折算 PCNT 计数 (countPerPeriod 以正常采样周期表示)
+    // → 定时器中断 → 主循环处理
+    inline void sampleStep(ThereminEngine& engine, const ThereminConfig& cfg, float countPerPeriod) {
+        unsigned long periodMs = timerPeriodUs / 1000;
+        advanceMs(periodMs);
+        pcntCount = (int)lroundf(countPerPeriod * periodMs / cfg.samplingPeriodMs);
+        fireTimer();
+        TEST_ASSERT_TRUE(engine.process());
+    }
+}
+
+#endif // HOST_TEST_SUPPORT_H
@@ -0,0 +1,123 @@
+// 校准按键去抖: 短按/长按判定、按下毛刺忽略、长按松开时的抖动不再触发短按 (基线重校准)
+// 运行: pio test -e native -f test_button -v
+
+#include <unity.h>
+#include "test_support.h"
+
+static ThereminConfig s_cfg;
+static const float BASE = 8000.0f;
+static const float HAND = 8.0f;     // 手在场时的计数下降 (每采样周期)
+
+void setUp(void) {
+    host::beginTest(s_cfg);
+    s_cfg.enableSpectralNotch = false;
+    s_cfg.warmStartEnable = false;
+    s_cfg.idlePowerEnable = false;
+}
+
+void tearDown(void) {}
+
+// 一个采样周期: 期间按顺序施加按键电平 (levels 以 -1 结束)，然后处理样本
+static void step(ThereminEngine& engine, float count, const int* levels = nullptr) {
+    for (int i = 0; levels && levels[i] >= 0; i++) host::setPin(s_cfg.buttonPin, levels[i]);
+    host::sampleStep(engine, s_cfg, count);
+}
+
+static void run(ThereminEngine& engine, float count, int samples) {
+    for (int i = 0; i < samples; i++) step(engine, count);
+}
+
+// 基线建立后手停在天线附近，smoothedFreq 与冻结基线相差约 HAND
+static void bootWithHand(ThereminEngine& engine) {
+    TEST_ASSERT_TRUE(engine.begin());
+    for (int i = 0; i < 2000 && !engine.isBaselineSet(); i++) step(engine, BASE);
+    TEST_ASSERT_TRUE(engine.isBaselineSet());
+    run(engine, BASE, 50);
+    run(engine, BASE - HAND, 25);
+    TEST_ASSERT_GREATER_THAN(HAND * 0.5f, engine.getFrozenBaseFreq() - engine.getSmoothedFreq());
+}
+
+// 重校准会把冻结基线拉到当前 smoothedFreq
+static bool recalibrated(ThereminEngine& engine) {
+    return fabs(engine.getFrozenBaseFreq() - engine.getSmoothedFreq()) < HAND * 0.5f;
+}
+
+static void test_short_press_recalibrates(void) {
+    ThereminEngine engine(s_cfg);
+    bootWithHand(engine);
+
+    const int press[] = {LOW, -1};
+    const int release[] = {HIGH, -1};
+    step(engine, BASE - HAND, press);
+    run(engine, BASE - HAND, 10);
+    TEST_ASSERT_FALSE(recalibrated(engine));
+    step(engine, BASE - HAND, release);
+    run(engine, BASE - HAND, 3);
+    TEST_ASSERT_TRUE(recalibrated(engine));
+    TEST_ASSERT_FALSE(engine.isCalibratingCurve());
+}
+
+// 采样间隙内的按下毛刺 (未保持 buttonDebounceMs) 不算按键
+static void test_glitch_ignored(void) {
+    ThereminEngine engine(s_cfg);
+    bootWithHand(engine);
+
+    const int glitch[] = {LOW, HIGH, LOW, HIGH, -1};
+    for (int i = 0; i < 5; i++) {
+        step(engine, BASE - HAND, glitch);
+        run(engine, BASE - HAND, 5);
+    }
+    TEST_ASSERT_FALSE(recalibrated(engine));
+}
+
+// 按下抖动后保持: 判为一次短按
+static void test_press_bounce_single_press(void) {
+    ThereminEngine engine(s_cfg);
+    bootWithHand(engine);
+
+    const int bounce[] = {LOW, HIGH, LOW, HIGH, LOW, -1};
+    const int release[] = {HIGH, -1};
+    step(engine, BASE - HAND, bounce);
+    run(engine, BASE - HAND, 10);
+    step(engine, BASE - HAND, release);
+    run(engine, BASE - HAND, 3);
+    TEST_ASSERT_TRUE(recalibrated(engine));
+}
+
+// 长按进入曲线校准；松开时跨越多个采样的抖动不触发短按
+static void test_long_press_release_bounce(void) {
+    ThereminEngine engine(s_cfg);
+    bootWithHand(engine);
+
+    const int press[] = {LOW, -1};
+    step(engine, BASE - HAND, press);
+    int held = (int)(s_cfg.curveLongPressMs / s_cfg.samplingPeriodMs) + 5;
+    run(engine, BASE - HAND, held);
+    TEST_ASSERT_TRUE(engine.isCalibratingCurve());
+
+    // 松开抖动: 第一个采样时读到低电平，第二个采样时已松开
+    const int bounceLow[] = {HIGH, LOW, HIGH, LOW, -1};
+    const int bounceHigh[] = {HIGH, LOW, HIGH, -1};
+    step(engine, BASE - HAND, bounceLow);
+    step(engine, BASE - HAND, bounceHigh);
+    run(engine, BASE - HAND, 10);
+    TEST_ASSERT_FALSE(recalibrated(engine));
+
+    // 稳定松开后重新响应短按
+    const int press2[] = {LOW, -1};
+    const int release[] = {HIGH, -1};
+    step(engine, BASE - HAND, press2);
+    run(engine, BASE - HAND, 5);
+    step(engine, BASE - HAND, release);
+    run(engine, BASE - HAND, 3);
+    TEST_ASSERT_TRUE(recalibrated(engine));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_short_press_recalibrates);
+    RUN_TEST(test_glitch_ignored);
+    RUN_TEST(test_press_bounce_single_press);
+    RUN_TEST(test_long_press_release_bounce);
+    return UNITY_END();
+}
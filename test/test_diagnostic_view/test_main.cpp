@@ -0,0 +1,204 @@
+// 诊断视图: 在 SPI 仿真链上逐帧校验滚动内容，把帧以文本形式写入文件，并测量渲染与传输开销
+// 运行: pio test -e native -f test_diagnostic_view -v  (帧写入 diagnostic_view_frames.txt，输出每帧开销)
+
+#include <unity.h>
+#include <vector>
+#include "test_support.h"
+#include "DiagnosticView.h"
+
+static const spi_host_device_t HOSTS[LED_CHAIN_MAX] = {SPI2_HOST, SPI3_HOST};
+static const float BASE = 20000.0f;
+static const int FRAMES = 300;
+static const char* FRAME_FILE = "diagnostic_view_frames.txt";
+
+void setUp(void) {
+    host::beginTest(config);
+    host::resetSpi();
+}
+
+void tearDown(void) {}
+
+// 合成信号: 手缓慢靠近又离开，基线缓慢漂移，每 40 帧出现一段抖动标志
+struct Sample {
+    float smoothedDelta;
+    float baseFreq;
+    bool jitter;
+};
+
+static Sample signalAt(int n) {
+    Sample s;
+    s.smoothedDelta = config.deltaFMax * 0.5f * (1.0f - cosf(2.0f * (float)M_PI * n / 120.0f));
+    s.baseFreq = BASE + 5.0f * sinf(2.0f * (float)M_PI * n / 200.0f);
+    s.jitter = (n % 40) < 5;
+    return s;
+}
+
+// 期望的列 (bit r = 第 r 行): 第0行抖动标志，柱高自底向上，基线点以第4行为中心
+static uint8_t expectedColumn(const Sample& s) {
+    uint8_t column = s.jitter ? 0x01 : 0;
+    int height = constrain((int)lroundf(s.smoothedDelta / config.deltaFMax * 7), 0, 7);
+    for (int i = 0; i < height; i++) column |= 1 << (7 - i);
+    int offset = (int)lroundf((s.baseFreq - BASE) / config.viewBaseCountsPerRow);
+    column |= 1 << constrain(4 - offset, 1, 7);
+    return column;
+}
+
+// 帧缓冲中第 module 个模块在对应链上的解码状态
+static const host::Max7219Module& chainModule(int module) {
+    int start = 0;
+    for (int c = 0; c < config.ledChainCount; c++) {
+        int count = config.ledModuleCount / config.ledChainCount +
+                    (c < config.ledModuleCount % config.ledChainCount ? 1 : 0);
+        if (module < start + count) return host::spi[HOSTS[c]].chain[module - start];
+        start += count;
+    }
+    TEST_FAIL_MESSAGE("module out of range");
+    return host::spi[0].chain[0];
+}
+
+// 链上实际显示的像素 (x 自左向右覆盖所有模块)
+static bool pixel(int x, int row) {
+    return (chainModule(x / 8).rows[row] >> (7 - x % 8)) & 1;
+}
+
+// 一帧的总字节数与线上时间 (各链并行，取最慢的链)
+static void frameCost(size_t& bytes, double& wireUs) {
+    bytes = 0;
+    wireUs = 0;
+    for (int c = 0; c < config.ledChainCount; c++) {
+        bytes += host::spi[HOSTS[c]].bytes;
+        wireUs = fmax(wireUs, host::spi[HOSTS[c]].wireUs);
+    }
+}
+
+// 最右列为最新样本；样本不足时左侧为空
+static void assertScrolled(const std::vector<uint8_t>& columns) {
+    int width = config.ledModuleCount * 8;
+    for (int x = 0; x < width; x++) {
+        int age = width - 1 - x;
+        uint8_t expected = age < (int)columns.size() ? columns[columns.size() - 1 - age] : 0;
+        for (int row = 0; row < 8; row++) {
+            if (pixel(x, row) != (bool)((expected >> row) & 1)) {
+                char msg[96];
+                snprintf(msg, sizeof(msg), "frame %u: pixel x=%d row=%d mismatch",
+                         (unsigned)columns.size(), x, row);
+                TEST_FAIL_MESSAGE(msg);
+            }
+        }
+    }
+}
+
+static void writeFrame(FILE* f, int frame, uint32_t renderUs, size_t bytes, double wireUs) {
+    fprintf(f, "frame %d  render %luus  spi %uB %.1fus\n", frame, (unsigned long)renderUs,
+            (unsigned)bytes, wireUs);
+    int width = config.ledModuleCount * 8;
+    for (int row = 0; row < 8; row++) {
+        for (int x = 0; x < width; x++) fputc(pixel(x, row) ? '#' : '.', f);
+        fputc('\n', f);
+    }
+    fputc('\n', f);
+}
+
+// 8 模块单链: 每帧与期望的滚动内容一致，帧写入文本文件
+static void test_scroll_frames_to_file(void) {
+    config.ledModuleCount = 8;
+    config.ledChainCount = 1;
+    DisplayController display;
+    TEST_ASSERT_TRUE(display.begin());
+    DiagnosticView view(display);
+    view.setEnabled(true, BASE);
+
+    FILE* f = fopen(FRAME_FILE, "w");
+    TEST_ASSERT_TRUE_MESSAGE(f != nullptr, "cannot open frame file");
+
+    std::vector<uint8_t> columns;
+    size_t totalBytes = 0, maxBytes = 0;
+    double totalWireUs = 0, maxWireUs = 0;
+    for (int n = 0; n < FRAMES; n++) {
+        host::advanceMs(config.viewFrameMs);
+        host::resetSpiStats();
+        Sample s = signalAt(n);
+        TEST_ASSERT_TRUE(view.update(millis(), s.smoothedDelta, s.baseFreq, s.jitter));
+        columns.push_back(expectedColumn(s));
+        assertScrolled(columns);
+
+        size_t bytes;
+        double wireUs;
+        frameCost(bytes, wireUs);
+        TEST_ASSERT_EQUAL_INT(bytes, display.getLastFlushBytes());
+        totalBytes += bytes;
+        maxBytes = max(maxBytes, bytes);
+        totalWireUs += wireUs;
+        maxWireUs = fmax(maxWireUs, wireUs);
+        writeFrame(f, n, view.getLastRenderUs(), bytes, wireUs);
+    }
+    fclose(f);
+
+    // 帧间隔未到时不渲染
+    TEST_ASSERT_FALSE(view.update(millis() + config.viewFrameMs - 1, 0, BASE, false));
+    TEST_ASSERT_EQUAL_UINT32(FRAMES, view.getFrameCount());
+
+    char msg[192];
+    snprintf(msg, sizeof(msg),
+             "%d frames -> %s | render max %luus | spi avg %.0f B %.1f us, max %u B %.1f us (frame budget %lu ms)",
+             FRAMES, FRAME_FILE, (unsigned long)view.getMaxRenderUs(), (double)totalBytes / FRAMES,
+             totalWireUs / FRAMES, (unsigned)maxBytes, maxWireUs, config.viewFrameMs);
+    TEST_MESSAGE(msg);
+}
+
+// 模块/链数 vs 每帧传输开销: 滚动时几乎每行都变化，传输量随模块数线性增长，多链并行缩短线上时间
+static void test_frame_cost_vs_modules(void) {
+    const int moduleCounts[] = {8, 16, 32};
+    for (int chains = 1; chains <= LED_CHAIN_MAX; chains++) {
+        for (int modules : moduleCounts) {
+            host::resetSpi();
+            config.ledModuleCount = modules;
+            config.ledChainCount = chains;
+            DisplayController display;
+            TEST_ASSERT_TRUE(display.begin());
+            DiagnosticView view(display);
+            view.setEnabled(true, BASE);
+
+            // 先填满整个区域，再测稳定滚动时的开销
+            std::vector<uint8_t> columns;
+            for (int n = 0; n < modules * 8; n++) {
+                host::advanceMs(config.viewFrameMs);
+                Sample s = signalAt(n);
+                view.update(millis(), s.smoothedDelta, s.baseFreq, s.jitter);
+                columns.push_back(expectedColumn(s));
+            }
+            size_t totalBytes = 0;
+            double totalWireUs = 0, maxWireUs = 0;
+            for (int n = modules * 8; n < modules * 8 + FRAMES; n++) {
+                host::advanceMs(config.viewFrameMs);
+                host::resetSpiStats();
+                Sample s = signalAt(n);
+                view.update(millis(), s.smoothedDelta, s.baseFreq, s.jitter);
+                columns.push_back(expectedColumn(s));
+                size_t bytes;
+                double wireUs;
+                frameCost(bytes, wireUs);
+                TEST_ASSERT_LESS_OR_EQUAL(8 * 2 * modules, bytes);
+                totalBytes += bytes;
+                totalWireUs += wireUs;
+                maxWireUs = fmax(maxWireUs, wireUs);
+            }
+            assertScrolled(columns);
+            TEST_ASSERT_LESS_THAN(config.viewFrameMs * 1000.0, maxWireUs);
+
+            char msg[160];
+            snprintf(msg, sizeof(msg),
+                     "%d chain(s) x %2d modules: render max %4luus | spi avg %5.0f B %6.1f us, max %6.1f us",
+                     chains, modules, (unsigned long)view.getMaxRenderUs(), (double)totalBytes / FRAMES,
+                     totalWireUs / FRAMES, maxWireUs);
+            TEST_MESSAGE(msg);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_scroll_frames_to_file);
+    RUN_TEST(test_frame_cost_vs_modules);
+    return UNITY_END();
+}
@@ -0,0 +1,134 @@
+// MAX7219 多链输出仿真: 逐模块校验帧内容、模块数/链数增长时每帧的字节数与线上时间、
+// 以及 SPI 队列满时未发出的行保留到下次刷新
+// 运行: pio test -e native -f test_display_chain -v  (输出各配置的每帧字节数与传输时间)
+
+#include <unity.h>
+#include "test_support.h"
+#include "DisplayController.h"
+
+static const spi_host_device_t HOSTS[LED_CHAIN_MAX] = {SPI2_HOST, SPI3_HOST};
+
+void setUp(void) {
+    host::beginTest(config);
+    host::resetSpi();
+}
+
+void tearDown(void) {}
+
+// 帧缓冲中第 module 个模块在对应链上的解码状态
+static const host::Max7219Module& chainModule(int module, int modules, int chains) {
+    int start = 0;
+    for (int c = 0; c < chains; c++) {
+        int count = modules / chains + (c < modules % chains ? 1 : 0);
+        if (module < start + count) return host::spi[HOSTS[c]].chain[module - start];
+        start += count;
+    }
+    TEST_FAIL_MESSAGE("module out of range");
+    return host::spi[0].chain[0];
+}
+
+// 前一半模块显示 left，后一半显示 right
+static void assertEyes(int modules, int chains, const byte* left, const byte* right) {
+    for (int m = 0; m < modules; m++) {
+        const byte* expected = m < modules / 2 ? left : right;
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, chainModule(m, modules, chains).rows, 8);
+    }
+}
+
+// 一帧的总字节数与线上时间 (各链并行，取最慢的链)
+static void frameCost(int chains, size_t& bytes, double& wireUs) {
+    bytes = 0;
+    wireUs = 0;
+    for (int c = 0; c < chains; c++) {
+        bytes += host::spi[HOSTS[c]].bytes;
+        wireUs = fmax(wireUs, host::spi[HOSTS[c]].wireUs);
+    }
+}
+
+static void test_frame_cost_vs_module_count(void) {
+    const int moduleCounts[] = {8, 16, 32};
+    for (int chains = 1; chains <= LED_CHAIN_MAX; chains++) {
+        for (int modules : moduleCounts) {
+            host::resetSpi();
+            config.ledModuleCount = modules;
+            config.ledChainCount = chains;
+            DisplayController display;
+            TEST_ASSERT_TRUE(display.begin());
+            for (int c = 0; c < chains; c++) {
+                TEST_ASSERT_EQUAL_UINT8(1, host::spi[HOSTS[c]].chain[0].shutdown);
+            }
+
+            // 整帧: 8 行全部变化 (EYE_OPEN 每行都非零)
+            host::resetSpiStats();
+            display.displayEyes(DisplayController::EYE_OPEN, DisplayController::EYE_OPEN);
+            assertEyes(modules, chains, DisplayController::EYE_OPEN, DisplayController::EYE_OPEN);
+            size_t fullBytes;
+            double fullUs;
+            frameCost(chains, fullBytes, fullUs);
+            TEST_ASSERT_EQUAL_UINT32(8 * 2 * modules, fullBytes);
+            TEST_ASSERT_EQUAL_INT(fullBytes, display.getLastFlushBytes());
+
+            // 局部更新: EYE_OPEN → EYE_SLIGHT_LEFT 只有 2 行变化
+            host::resetSpiStats();
+            display.updateEyes(6);
+            assertEyes(modules, chains, DisplayController::EYE_SLIGHT_LEFT, DisplayController::EYE_SLIGHT_LEFT);
+            size_t partBytes;
+            double partUs;
+            frameCost(chains, partBytes, partUs);
+            TEST_ASSERT_EQUAL_UINT32(2 * 2 * modules, partBytes);
+
+            char msg[160];
+            snprintf(msg, sizeof(msg),
+                     "%d chain(s) x %2d modules: full frame %4u B %6.1f us | partial %4u B %6.1f us",
+                     chains, modules, (unsigned)fullBytes, fullUs, (unsigned)partBytes, partUs);
+            TEST_MESSAGE(msg);
+        }
+    }
+}
+
+// 链数增加时每帧线上时间按链数缩短 (各链并行)
+static void test_two_chains_halve_wire_time(void) {
+    double us[LED_CHAIN_MAX + 1] = {0};
+    for (int chains = 1; chains <= LED_CHAIN_MAX; chains++) {
+        host::resetSpi();
+        config.ledModuleCount = 32;
+        config.ledChainCount = chains;
+        DisplayController display;
+        TEST_ASSERT_TRUE(display.begin());
+        host::resetSpiStats();
+        display.displayEyes(DisplayController::EYE_OPEN, DisplayController::EYE_OPEN);
+        size_t bytes;
+        frameCost(chains, bytes, us[chains]);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, us[1] / 2, us[2]);
+}
+
+// SPI 队列只接受 3 个事务: 未排队的行保持脏标记，下一次刷新补发，最终帧完整
+static void test_queue_failure_keeps_dirty_rows(void) {
+    config.ledModuleCount = 8;
+    config.ledChainCount = 1;
+    DisplayController display;
+    TEST_ASSERT_TRUE(display.begin());
+
+    host::resetSpiStats();
+    host::spiQueueBudget = 3;
+    display.updateEyes(5);
+    TEST_ASSERT_EQUAL_UINT32(3, host::spi[SPI2_HOST].transactions);
+
+    host::spiQueueBudget = -1;
+    display.updateEyes(5);              // looking 未变: 只补发剩余的脏行
+    assertEyes(8, 1, DisplayController::EYE_OPEN, DisplayController::EYE_OPEN);
+    TEST_ASSERT_EQUAL_UINT32(8, host::spi[SPI2_HOST].transactions);
+
+    host::resetSpiStats();
+    display.updateEyes(5);              // 无脏行: 不产生传输
+    TEST_ASSERT_EQUAL_UINT32(0, host::spi[SPI2_HOST].transactions);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_frame_cost_vs_module_count);
+    RUN_TEST(test_two_chains_halve_wire_time);
+    RUN_TEST(test_queue_failure_keeps_dirty_rows);
+    return UNITY_END();
+}
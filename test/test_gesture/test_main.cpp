@@ -0,0 +1,158 @@
+// 手势识别: 合成 delta 轨迹 (20ms 采样) 的分类结果，以及手势包格式校验
+// 运行: pio test -e native -f test_gesture -v
+
+#include <unity.h>
+#include <vector>
+#include "GestureDetector.h"
+#include "test_support.h"
+#include "RadioProtocol.h"
+
+static std::vector<GestureEvent> s_events;
+
+static void collect(const GestureEvent& ev) { s_events.push_back(ev); }
+
+void setUp(void) {
+    host::beginTest(config);
+    s_events.clear();
+}
+
+void tearDown(void) {}
+
+// 分段线性轨迹: {持续毫秒, 段末delta}，段内线性插值
+struct Segment { unsigned long ms; float delta; };
+
+static void play(GestureDetector& det, const Segment* segs, int count, unsigned long& now, float& delta) {
+    for (int s = 0; s < count; s++) {
+        float start = delta;
+        int steps = segs[s].ms / SAMPLING_PERIOD_MS;
+        for (int i = 1; i <= steps; i++) {
+            delta = start + (segs[s].delta - start) * i / steps;
+            now += SAMPLING_PERIOD_MS;
+            det.update(now, delta, delta > start ? -1 : (delta < start ? 1 : 0));
+        }
+    }
+}
+
+static std::vector<GestureType> runTrace(const Segment* segs, int count) {
+    GestureDetector det;
+    det.setCallback(collect);
+    unsigned long now = 0;
+    float delta = 0;
+    play(det, segs, count, now, delta);
+    std::vector<GestureType> types;
+    for (const GestureEvent& ev : s_events) types.push_back(ev.type);
+    return types;
+}
+
+static void assertTypes(const std::vector<GestureType>& got, std::initializer_list<GestureType> expected) {
+    char msg[128];
+    int len = snprintf(msg, sizeof(msg), "got:");
+    for (GestureType t : got) len += snprintf(msg + len, sizeof(msg) - len, " %s", GestureDetector::typeName(t));
+    TEST_ASSERT_EQUAL_MESSAGE(expected.size(), got.size(), msg);
+    size_t i = 0;
+    for (GestureType t : expected) TEST_ASSERT_EQUAL_MESSAGE(t, got[i++], msg);
+}
+
+static void test_tap_short_high_peak(void) {
+    const Segment trace[] = {{200, 0}, {100, 12}, {120, 12}, {100, 0}, {400, 0}};
+    assertTypes(runTrace(trace, 5), {GESTURE_APPROACH, GESTURE_TAP});
+    TEST_ASSERT_GREATER_OR_EQUAL(GESTURE_TAP_PEAK, s_events[1].peakDelta);
+    TEST_ASSERT_LESS_OR_EQUAL(GESTURE_SHORT_MS, s_events[1].durationMs);
+}
+
+static void test_swipe_short_low_peak(void) {
+    const Segment trace[] = {{200, 0}, {100, 5}, {100, 5}, {100, 0}, {400, 0}};
+    assertTypes(runTrace(trace, 5), {GESTURE_APPROACH, GESTURE_SWIPE});
+    TEST_ASSERT_LESS_THAN(GESTURE_TAP_PEAK, s_events[1].peakDelta);
+}
+
+static void test_hover_then_withdraw(void) {
+    const Segment trace[] = {{200, 0}, {300, 8}, {1200, 8}, {300, 0}, {400, 0}};
+    assertTypes(runTrace(trace, 5), {GESTURE_APPROACH, GESTURE_HOVER, GESTURE_WITHDRAW});
+    TEST_ASSERT_GREATER_THAN(GESTURE_SHORT_MS, s_events[2].durationMs);
+}
+
+// 悬停后移动再停下: 每次停留各触发一次 hover
+static void test_hover_rearms_after_movement(void) {
+    const Segment trace[] = {{200, 0}, {200, 6}, {1000, 6}, {200, 10}, {1000, 10}, {200, 0}, {200, 0}};
+    assertTypes(runTrace(trace, 7), {GESTURE_APPROACH, GESTURE_HOVER, GESTURE_HOVER, GESTURE_WITHDRAW});
+}
+
+// 短于 gestureMinMs 的尖峰视为噪声
+static void test_short_blip_rejected(void) {
+    GestureDetector det;
+    det.setCallback(collect);
+    unsigned long now = 0;
+    float delta = 0;
+    const Segment trace[] = {{200, 0}, {20, 6}, {20, 0}, {400, 0}};
+    play(det, trace, 4, now, delta);
+    TEST_ASSERT_EQUAL(0, s_events.size());
+    TEST_ASSERT_EQUAL_UINT32(1, det.getRejectedCount());
+}
+
+// 低于出现阈值的慢速抖动 (环境噪声) 不产生事件
+static void test_sub_threshold_noise_ignored(void) {
+    std::vector<Segment> trace;
+    for (int i = 0; i < 50; i++) trace.push_back({60, (i % 2) ? GESTURE_PRESENCE_ON * 0.8f : 0.5f});
+    runTrace(trace.data(), (int)trace.size());
+    TEST_ASSERT_EQUAL(0, s_events.size());
+}
+
+// 完整管线: 原始计数轨迹 → 引擎平滑 delta → 手势
+// 冷启动基线建立后频率EMA仍在收敛，跳过前 settle 个样本再送入检测器
+static void test_engine_trace_approach_withdraw(void) {
+    ThereminConfig cfg;
+    cfg.enableSpectralNotch = false;
+    cfg.enableResponseCurve = false;
+    ThereminEngine engine(cfg);
+    engine.beginOffline();
+    GestureDetector det;
+    det.setCallback(collect);
+
+    const int n = 1500, settle = 400, handStart = 800, handEnd = 900;
+    for (int i = 0; i < n; i++) {
+        float count = 20000.0f - ((i >= handStart && i < handEnd) ? 10.0f : 0.0f);
+        EngineOutput out;
+        engine.processBlock(&count, &out, 1, i * SAMPLING_PERIOD_MS);
+        if (i >= settle && engine.isBaselineSet()) det.update(i * SAMPLING_PERIOD_MS, out.smoothedDelta, out.direction);
+    }
+
+    TEST_ASSERT_GREATER_OR_EQUAL(2, s_events.size());
+    TEST_ASSERT_EQUAL(GESTURE_APPROACH, s_events.front().type);
+    TEST_ASSERT_GREATER_OR_EQUAL(handStart * SAMPLING_PERIOD_MS, s_events.front().timestampMs);
+    TEST_ASSERT_EQUAL(-1, s_events.front().direction);    // 手靠近 → 频率下降
+    TEST_ASSERT_EQUAL(GESTURE_WITHDRAW, s_events.back().type);
+}
+
+// 包格式: 只有长度 + magic + 版本都匹配的包才被识别为手势
+static void test_gesture_packet_validation(void) {
+    gesture_message msg = {};
+    msg.magic = GESTURE_MSG_MAGIC;
+    msg.version = GESTURE_MSG_VERSION;
+    msg.type = GESTURE_TAP;
+    const uint8_t* p = (const uint8_t*)&msg;
+    TEST_ASSERT_EQUAL(14, sizeof(gesture_message));
+    TEST_ASSERT_TRUE(isGestureMessage(p, sizeof(msg)));
+
+    TEST_ASSERT_FALSE(isGestureMessage(p, 11));                     // 旧版 11 字节格式
+    TEST_ASSERT_FALSE(isGestureMessage(p, sizeof(struct_message)));
+    msg.version = GESTURE_MSG_VERSION + 1;
+    TEST_ASSERT_FALSE(isGestureMessage(p, sizeof(msg)));
+
+    // 以 'G' (0x47) 开头的 18 字节状态包不会被误认
+    state_message state = {0x47, 0, 0, 0, 0};
+    TEST_ASSERT_FALSE(isGestureMessage((const uint8_t*)&state, sizeof(state)));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_tap_short_high_peak);
+    RUN_TEST(test_swipe_short_low_peak);
+    RUN_TEST(test_hover_then_withdraw);
+    RUN_TEST(test_hover_rearms_after_movement);
+    RUN_TEST(test_short_blip_rejected);
+    RUN_TEST(test_sub_threshold_noise_ignored);
+    RUN_TEST(test_engine_trace_approach_withdraw);
+    RUN_TEST(test_gesture_packet_validation);
+    return UNITY_END();
+}
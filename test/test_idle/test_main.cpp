@@ -0,0 +1,180 @@
+// 空闲省电仿真: 进入/退出、唤醒延迟 (样本数)、高输入频率下空闲周期按 PCNT 上限缩短
+// 运行: pio test -e native -f test_idle -v  (输出唤醒延迟与活动占比，含一天的使用轨迹)
+
+#include <unity.h>
+#include "test_support.h"
+
+static ThereminConfig s_cfg;
+
+void setUp(void) {
+    host::beginTest(s_cfg);
+    s_cfg.enableSpectralNotch = false;
+    s_cfg.enableResponseCurve = false;
+    s_cfg.warmStartEnable = false;
+    s_cfg.idleTimeoutMs = 5000;
+}
+
+void tearDown(void) {}
+
+static void bootToBaseline(ThereminEngine& engine, float count) {
+    TEST_ASSERT_TRUE(engine.begin());
+    for (int i = 0; i < 2000 && !engine.isBaselineSet(); i++) host::sampleStep(engine, s_cfg, count);
+    TEST_ASSERT_TRUE(engine.isBaselineSet());
+}
+
+// 静止超过 idleTimeoutMs 后进入空闲，采样周期切换到 idleSamplingPeriodMs
+static int runUntilIdle(ThereminEngine& engine, float count) {
+    int samples = 0;
+    while (!engine.isIdle() && samples < 2000) {
+        host::sampleStep(engine, s_cfg, count);
+        samples++;
+    }
+    return samples;
+}
+
+static void test_enter_idle_after_timeout(void) {
+    const float base = 8000.0f;
+    ThereminEngine engine(s_cfg);
+    bootToBaseline(engine, base);
+    unsigned long start = millis();
+    runUntilIdle(engine, base);
+    TEST_ASSERT_TRUE(engine.isIdle());
+    TEST_ASSERT_GREATER_OR_EQUAL(s_cfg.idleTimeoutMs, millis() - start);
+    TEST_ASSERT_EQUAL_INT(s_cfg.idleSamplingPeriodMs, engine.getSamplingPeriodMs());
+    TEST_ASSERT_EQUAL_UINT32(s_cfg.idleSamplingPeriodMs * 1000UL, host::timerPeriodUs);
+}
+
+// 手出现 (原始 delta 阶跃) 后第一个空闲样本即唤醒
+static void test_wake_within_one_idle_period(void) {
+    const float base = 8000.0f;
+    ThereminEngine engine(s_cfg);
+    bootToBaseline(engine, base);
+    runUntilIdle(engine, base);
+    for (int i = 0; i < 20; i++) host::sampleStep(engine, s_cfg, base);
+    TEST_ASSERT_TRUE(engine.isIdle());
+
+    const float steps[] = {s_cfg.idleWakeDelta * 1.5f, 5.0f, 15.0f};
+    char msg[160];
+    int len = snprintf(msg, sizeof(msg), "wake latency (idle period %d ms):", s_cfg.idleSamplingPeriodMs);
+    for (float hand : steps) {
+        if (!engine.isIdle()) {
+            runUntilIdle(engine, base);
+        }
+        unsigned long handAt = millis();
+        int samples = 0;
+        while (engine.isIdle() && samples < 50) {
+            host::sampleStep(engine, s_cfg, base - hand);
+            samples++;
+        }
+        TEST_ASSERT_FALSE(engine.isIdle());
+        TEST_ASSERT_EQUAL_INT(1, samples);
+        len += snprintf(msg + len, sizeof(msg) - len, " delta %.1f -> %lu ms", hand, millis() - handAt);
+        for (int i = 0; i < 50; i++) host::sampleStep(engine, s_cfg, base);   // 手离开，基线恢复
+    }
+    TEST_MESSAGE(msg);
+}
+
+// 噪声 (低于唤醒阈值) 不唤醒
+static void test_noise_does_not_wake(void) {
+    const float base = 8000.0f;
+    ThereminEngine engine(s_cfg);
+    bootToBaseline(engine, base);
+    runUntilIdle(engine, base);
+    for (int i = 0; i < 500; i++) {
+        host::sampleStep(engine, s_cfg, base + ((i % 3) - 1) * s_cfg.idleWakeDelta * 0.5f);
+    }
+    TEST_ASSERT_TRUE(engine.isIdle());
+}
+
+// 输入 1MHz (20ms 内 20000 计数): 60ms 空闲周期会超出 PCNT 上限，周期被缩短且计数不溢出
+static void test_idle_period_clamped_below_pcnt_limit(void) {
+    const float base = 20000.0f;
+    ThereminEngine engine(s_cfg);
+    bootToBaseline(engine, base);
+    runUntilIdle(engine, base);
+    TEST_ASSERT_TRUE(engine.isIdle());
+    int period = engine.getSamplingPeriodMs();
+    TEST_ASSERT_LESS_THAN(s_cfg.idleSamplingPeriodMs, period);
+    TEST_ASSERT_GREATER_THAN(s_cfg.samplingPeriodMs, period);
+    TEST_ASSERT_LESS_OR_EQUAL(s_cfg.pcntCountLimit, base * period / s_cfg.samplingPeriodMs);
+    for (int i = 0; i < 200; i++) host::sampleStep(engine, s_cfg, base);
+    TEST_ASSERT_EQUAL_UINT32(0, host::pcntOverflows);
+    TEST_ASSERT_TRUE(engine.isIdle());
+}
+
+// 会话: 1 分钟内两次短暂交互，报告活动占比 (正常采样率运行的时间比例)
+static void test_active_fraction_session(void) {
+    const float base = 8000.0f;
+    ThereminEngine engine(s_cfg);
+    bootToBaseline(engine, base);
+    unsigned long sessionEnd = millis() + 60000;
+    unsigned long handStart[] = {millis() + 15000, millis() + 40000};
+    uint32_t samples = 0;
+    while (millis() < sessionEnd) {
+        bool hand = false;
+        for (unsigned long t : handStart) hand |= millis() >= t && millis() < t + 2000;
+        host::sampleStep(engine, s_cfg, hand ? base - 10.0f : base);
+        samples++;
+    }
+    float active = engine.getActiveFraction();
+    char msg[128];
+    snprintf(msg, sizeof(msg), "60 s session, 2 x 2 s hand: active %.1f%%, %lu samples processed",
+             active * 100.0f, (unsigned long)samples);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_THAN(0.9f, active);
+    TEST_ASSERT_LESS_THAN(60000 / s_cfg.samplingPeriodMs, samples);
+}
+
+// 一天的使用轨迹: 24 小时中 8 次演奏 (每次 10 分钟，手 3 秒在/2 秒离开交替)、
+// 6 次路过 (手短暂出现 1 秒)，其余时间无人；基线随温度缓慢漂移。
+// 使用默认空闲超时，报告全天活动占比与实际处理的样本数 (相对始终 20ms 采样)
+static void test_active_fraction_day(void) {
+    s_cfg.idleTimeoutMs = IDLE_TIMEOUT_MS;
+    const float base = 8000.0f;
+    const unsigned long HOUR = 3600000UL;
+    const unsigned long sessions[] = {8 * HOUR + 600000, 9 * HOUR + 1800000, 12 * HOUR + 900000,
+                                      13 * HOUR, 17 * HOUR + 2400000, 19 * HOUR + 300000,
+                                      20 * HOUR + 1800000, 22 * HOUR + 600000};
+    const unsigned long passes[] = {7 * HOUR, 10 * HOUR + 1200000, 11 * HOUR, 15 * HOUR + 600000,
+                                    16 * HOUR + 3000000, 23 * HOUR + 1200000};
+    const unsigned long sessionMs = 600000;
+
+    ThereminEngine engine(s_cfg);
+    bootToBaseline(engine, base);
+    unsigned long start = millis();
+    uint32_t samples = 0;
+    while (millis() - start < 24 * HOUR) {
+        unsigned long t = millis() - start;
+        bool hand = false;
+        for (unsigned long s : sessions) {
+            hand |= t >= s && t < s + sessionMs && (t - s) % 5000 < 3000;
+        }
+        for (unsigned long p : passes) hand |= t >= p && t < p + 1000;
+        float drift = 3.0f * sinf(2.0f * (float)M_PI * t / (24.0f * HOUR));
+        host::sampleStep(engine, s_cfg, base + drift - (hand ? 10.0f : 0.0f));
+        samples++;
+    }
+
+    float active = engine.getActiveFraction();
+    uint32_t alwaysOn = 24 * HOUR / s_cfg.samplingPeriodMs;
+    char msg[160];
+    snprintf(msg, sizeof(msg), "24 h trace, 8 x 10 min sessions + 6 passes: active %.1f%%, %lu samples processed "
+             "(%.1f%% of always-on)", active * 100.0f, (unsigned long)samples, samples * 100.0f / alwaysOn);
+    TEST_MESSAGE(msg);
+
+    // 演奏 80 分钟 + 每次活动后的超时 (14 x 5 分钟) ≈ 10.4%
+    TEST_ASSERT_GREATER_THAN(0.05f, active);
+    TEST_ASSERT_LESS_THAN(0.15f, active);
+    TEST_ASSERT_LESS_THAN(alwaysOn / 2, samples);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_enter_idle_after_timeout);
+    RUN_TEST(test_wake_within_one_idle_period);
+    RUN_TEST(test_noise_does_not_wake);
+    RUN_TEST(test_idle_period_clamped_below_pcnt_limit);
+    RUN_TEST(test_active_fraction_session);
+    RUN_TEST(test_active_fraction_day);
+    return UNITY_END();
+}
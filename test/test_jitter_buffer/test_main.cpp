@@ -0,0 +1,175 @@
+// 接收端抖动缓冲: 乱序重排、丢包计数与插值隐藏、发送端重启后的重新同步
+// 运行: pio test -e native -f test_jitter_buffer -v  (输出各场景的统计)
+
+#include <unity.h>
+#include <algorithm>
+#include <vector>
+#include "test_support.h"
+#include "JitterBuffer.h"
+
+struct Packet {
+    unsigned long arrivalMs;
+    PlayoutSample sample;
+};
+
+// 发送端: 每 period 毫秒 looking 变化一次 (仅变化时发包)
+struct Sender {
+    uint16_t seq;
+    uint32_t clockMs;               // 发送端 millis()
+    int looking = 0;
+
+    PlayoutSample next(uint32_t periodMs) {
+        clockMs += periodMs;
+        looking = (looking + 1) % 9;
+        PlayoutSample s;
+        s.seq = seq++;
+        s.senderMs = clockMs;
+        s.looking = looking;
+        s.duty = looking * 32;
+        return s;
+    }
+};
+
+// 按到达时刻排序后推入，播放时钟每 playoutPeriodMs 取一帧；记录输出的 looking 序列
+static void run(JitterBuffer& jb, std::vector<Packet> packets, unsigned long untilMs,
+                std::vector<int>* played = nullptr) {
+    std::stable_sort(packets.begin(), packets.end(),
+                     [](const Packet& a, const Packet& b) { return a.arrivalMs < b.arrivalMs; });
+    size_t i = 0;
+    int last = -1;
+    for (unsigned long now = 0; now <= untilMs; now += config.playoutPeriodMs) {
+        while (i < packets.size() && packets[i].arrivalMs <= now) {
+            jb.push(packets[i].sample, packets[i].arrivalMs);
+            i++;
+        }
+        PlayoutFrame frame;
+        if (jb.playout(now, frame) && played && !frame.concealed && frame.looking != last) {
+            played->push_back(frame.looking);
+            last = frame.looking;
+        }
+    }
+}
+
+static void report(const char* label, const JitterStats& st) {
+    char msg[192];
+    snprintf(msg, sizeof(msg), "%s: n %lu late %lu dup %lu lost %lu resync %lu conc %lu/%lu jit %.1fms delay %.1fms",
+             label, (unsigned long)st.received, (unsigned long)st.late, (unsigned long)st.duplicates,
+             (unsigned long)st.lost, (unsigned long)st.resyncs, (unsigned long)st.concealedTicks,
+             (unsigned long)st.ticks, st.jitterMs, st.delayMs);
+    TEST_MESSAGE(msg);
+}
+
+void setUp(void) {
+    host::beginTest(config);
+}
+
+void tearDown(void) {}
+
+// 传输时间在 2-12 ms 间随机，间隔 6 ms 发包时相邻包经常乱序到达；重排后按发送顺序播放
+static void test_reorder(void) {
+    JitterBuffer jb;
+    Sender tx = {100, 50000};
+    std::vector<Packet> packets;
+    std::vector<int> sent;
+    unsigned long t = 0;
+    for (int i = 0; i < 500; i++) {
+        t += 6;
+        PlayoutSample s = tx.next(6);
+        packets.push_back({t + 2 + host::random24() % 11, s});
+        sent.push_back(s.looking);
+    }
+    std::vector<int> played;
+    run(jb, packets, t + 500, &played);
+
+    const JitterStats& st = jb.getStats();
+    report("reorder", st);
+    TEST_ASSERT_EQUAL_UINT32(500, st.received);
+    TEST_ASSERT_EQUAL_UINT32(0, st.late);
+    TEST_ASSERT_EQUAL_UINT32(0, st.lost);
+    TEST_ASSERT_EQUAL_UINT32(0, st.resyncs);
+    // 播放时钟 10 ms 一拍，6 ms 间隔的样本部分被合并；已播放的值必须保持发送顺序
+    size_t k = 0;
+    for (int v : played) {
+        while (k < sent.size() && sent[k] != v) k++;
+        TEST_ASSERT_TRUE_MESSAGE(k < sent.size(), "played value out of sender order");
+    }
+}
+
+// 每 7 个包丢 1 个: 丢包数准确计数，缺口处插值隐藏
+static void test_loss(void) {
+    JitterBuffer jb;
+    Sender tx = {0, 1000};
+    std::vector<Packet> packets;
+    unsigned long t = 0;
+    uint32_t dropped = 0;
+    for (int i = 0; i < 350; i++) {
+        t += 30;
+        PlayoutSample s = tx.next(30);
+        if (i % 7 == 3) {
+            dropped++;
+            continue;
+        }
+        packets.push_back({t + 5, s});
+    }
+    run(jb, packets, t + 500);
+
+    const JitterStats& st = jb.getStats();
+    report("loss", st);
+    TEST_ASSERT_EQUAL_UINT32(dropped, st.lost);
+    TEST_ASSERT_EQUAL_UINT32(0, st.late);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, st.concealedTicks);
+}
+
+// 发送端重启: 序号与时间戳从头开始。重新同步一次，之后按新流正常播放
+static void restartCase(uint16_t firstSeq, const char* label) {
+    JitterBuffer jb;
+    Sender tx = {firstSeq, 600000};     // 运行了 10 分钟的发送端
+    std::vector<Packet> packets;
+    unsigned long t = 0;
+    for (int i = 0; i < 300; i++) {
+        t += 20;
+        packets.push_back({t + 4, tx.next(20)});
+    }
+
+    t += 1500;                          // 重启耗时
+    Sender rebooted = {0, 300};
+    std::vector<int> sentAfter;
+    for (int i = 0; i < 300; i++) {
+        t += 20;
+        PlayoutSample s = rebooted.next(20);
+        packets.push_back({t + 4, s});
+        sentAfter.push_back(s.looking);
+    }
+    std::vector<int> played;
+    run(jb, packets, t + 500, &played);
+
+    const JitterStats& st = jb.getStats();
+    report(label, st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.resyncs);
+    TEST_ASSERT_EQUAL_UINT32(0, st.late);
+    TEST_ASSERT_EQUAL_UINT32(0, st.lost);
+
+    // 重启后的样本全部被播放 (每个值变化一次)
+    TEST_ASSERT_GREATER_OR_EQUAL(sentAfter.size(), played.size());
+    std::vector<int> tail(played.end() - sentAfter.size(), played.end());
+    TEST_ASSERT_TRUE(tail == sentAfter);
+}
+
+// 重启前序号较小: 序号大幅回退
+static void test_restart_seq_backward(void) {
+    restartCase(1000, "restart (seq back)");
+}
+
+// 重启前序号已超过半圈 (回退在 16 位序号空间里表现为前跳): 由时间戳回退识别
+static void test_restart_seq_wrapped(void) {
+    restartCase(40000, "restart (seq wrapped)");
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_reorder);
+    RUN_TEST(test_loss);
+    RUN_TEST(test_restart_seq_backward);
+    RUN_TEST(test_restart_seq_wrapped);
+    return UNITY_END();
+}
@@ -0,0 +1,133 @@
+// processBlock: 整块处理与逐样本处理的输出必须逐位一致，并对比两者的每样本耗时
+// 运行: pio test -e native -f test_process_block
+
+#include <unity.h>
+#include "test_support.h"
+
+static const int TRACE_LEN = 4096;
+static float s_trace[TRACE_LEN];
+static EngineOutput s_block[TRACE_LEN];
+static EngineOutput s_single[TRACE_LEN];
+
+// 基线 20000 计数 + 0.3 噪声 + 12.5Hz 干扰，中段手快速靠近 (200ms 内 delta 到 15)，停留 4 秒后离开
+static void makeTrace() {
+    host::seed = 12345;
+    for (int i = 0; i < TRACE_LEN; i++) {
+        float hand = 0;
+        if (i >= 1500 && i < 1510) hand = (i - 1500) * 1.5f;
+        else if (i >= 1510 && i < 1700) hand = 15.0f;
+        float hum = 0.8f * sinf(2.0f * (float)M_PI * 12.5f * i * SAMPLING_PERIOD_MS / 1000.0f);
+        s_trace[i] = 20000.0f - hand + hum + host::noise(0.3f);
+    }
+}
+
+static bool sameOutput(const EngineOutput& a, const EngineOutput& b) {
+    return a.delta == b.delta && a.smoothedDelta == b.smoothedDelta &&
+           a.direction == b.direction && a.looking == b.looking && a.duty == b.duty;
+}
+
+// 每次用新的配置副本，避免 beginOffline 修改全局配置影响其他用例
+static ThereminConfig s_cfg;
+
+void setUp(void) {
+    host::beginTest(s_cfg);
+    makeTrace();
+}
+
+void tearDown(void) {}
+
+static void runSingle(ThereminEngine& engine, EngineOutput* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        engine.processBlock(&s_trace[i], &out[i], 1, i * SAMPLING_PERIOD_MS);
+    }
+}
+
+static void test_block_matches_per_sample(void) {
+    ThereminEngine block(s_cfg), single(s_cfg);
+    block.beginOffline();
+    single.beginOffline();
+
+    block.processBlock(s_trace, s_block, TRACE_LEN, 0);
+    runSingle(single, s_single, TRACE_LEN);
+
+    for (int i = 0; i < TRACE_LEN; i++) {
+        if (!sameOutput(s_block[i], s_single[i])) {
+            char msg[96];
+            snprintf(msg, sizeof(msg), "sample %d: looking %d/%d duty %d/%d", i,
+                     s_block[i].looking, s_single[i].looking, s_block[i].duty, s_single[i].duty);
+            TEST_FAIL_MESSAGE(msg);
+        }
+    }
+    TEST_ASSERT_TRUE(block.isBaselineSet());
+    TEST_ASSERT_EQUAL_FLOAT(single.getFrozenBaseFreq(), block.getFrozenBaseFreq());
+    // 手靠近段应有非零输出，离开后回到 0
+    TEST_ASSERT_GREATER_THAN(4, s_block[1650].looking);
+    TEST_ASSERT_EQUAL_UINT8(0, s_block[TRACE_LEN - 1].looking);
+}
+
+// 非整块长度: 跨越 BLOCK_MAX_SAMPLES 边界的分块与逐样本一致
+static void test_block_boundary_split(void) {
+    const size_t n = BLOCK_MAX_SAMPLES * 3 + 7;
+    ThereminEngine block(s_cfg), single(s_cfg);
+    block.beginOffline();
+    single.beginOffline();
+
+    size_t done = 0;
+    const size_t chunks[] = {5, BLOCK_MAX_SAMPLES + 1, BLOCK_MAX_SAMPLES * 2 + 1};
+    for (size_t c : chunks) {
+        block.processBlock(&s_trace[done], &s_block[done], c, done * SAMPLING_PERIOD_MS);
+        done += c;
+    }
+    TEST_ASSERT_EQUAL(n, done);
+    runSingle(single, s_single, n);
+    for (size_t i = 0; i < n; i++) TEST_ASSERT_TRUE(sameOutput(s_block[i], s_single[i]));
+}
+
+// deltaFMax == deltaFMin: 映射区间为空时按阶跃输出，不在采样路径上整数除零
+static void test_empty_mapping_range_steps(void) {
+    s_cfg.deltaFMax = s_cfg.deltaFMin;
+    ThereminEngine block(s_cfg);
+    block.beginOffline();
+    block.processBlock(s_trace, s_block, TRACE_LEN, 0);
+
+    TEST_ASSERT_TRUE(block.isBaselineSet());
+    TEST_ASSERT_GREATER_THAN(0, s_block[1650].looking);
+    TEST_ASSERT_EQUAL_UINT8(0, s_block[TRACE_LEN - 1].looking);
+    for (int i = 0; i < TRACE_LEN; i++) {
+        TEST_ASSERT_LESS_OR_EQUAL(8, s_block[i].looking);
+    }
+}
+
+// 基准: 同一轨迹重复处理，报告每样本纳秒数 (主机上的绝对值只用于两种方式的相对比较)
+static void test_benchmark_block_vs_single(void) {
+    const int reps = 20;
+    double blockNs = 0, singleNs = 0;
+    for (int r = 0; r < reps; r++) {
+        ThereminEngine block(s_cfg), single(s_cfg);
+        block.beginOffline();
+        single.beginOffline();
+
+        unsigned long t0 = micros();
+        block.processBlock(s_trace, s_block, TRACE_LEN, 0);
+        unsigned long t1 = micros();
+        runSingle(single, s_single, TRACE_LEN);
+        unsigned long t2 = micros();
+
+        blockNs += (t1 - t0) * 1000.0 / TRACE_LEN;
+        singleNs += (t2 - t1) * 1000.0 / TRACE_LEN;
+    }
+    char msg[128];
+    snprintf(msg, sizeof(msg), "block(%d): %.1f ns/sample, per-sample: %.1f ns/sample, ratio %.2f",
+             BLOCK_MAX_SAMPLES, blockNs / reps, singleNs / reps, singleNs / blockNs);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(blockNs > 0 && singleNs > 0);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_block_matches_per_sample);
+    RUN_TEST(test_block_boundary_split);
+    RUN_TEST(test_empty_mapping_range_steps);
+    RUN_TEST(test_benchmark_block_vs_single);
+    return UNITY_END();
+}
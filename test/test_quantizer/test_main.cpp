@@ -0,0 +1,89 @@
+// 输出量化器: 回放悬停轨迹，对比量化器开/关时的显示帧数 (looking 变化) 与无线包数 (looking 或 duty 变化)
+// 运行: pio test -e native -f test_quantizer -v  (输出各轨迹的帧数、包数及节省量)
+
+#include <unity.h>
+#include "test_support.h"
+
+static const int TRACE_LEN = 6000;
+static float s_trace[TRACE_LEN];
+static EngineOutput s_out[TRACE_LEN];
+
+// 基线 20000 计数 + ±1 噪声；中段手悬停在 delta ≈ 12 处 (drift 为缓慢漂移幅度)
+static void makeHoverTrace(float drift) {
+    host::seed = 3;
+    for (int i = 0; i < TRACE_LEN; i++) {
+        float hand = (i > 1500 && i < 5500) ? 12.0f + drift * sinf(i * 0.02f) : 0.0f;
+        s_trace[i] = 20000.0f - hand + host::noise(1.0f);
+    }
+}
+
+struct ReplayCounts {
+    uint32_t frames;                // looking 变化 → 一次显示刷新
+    uint32_t packets;               // looking 或 duty 变化 → 一个 ESP-NOW 包
+    QuantizerStats stats;
+};
+
+static ThereminConfig s_cfg;
+
+void setUp(void) {
+    host::beginTest(s_cfg);
+    s_cfg.enableSpectralNotch = false;
+}
+
+void tearDown(void) {}
+
+static ReplayCounts replay(bool quantize) {
+    ThereminConfig cfg = s_cfg;
+    cfg.enableOutputQuantizer = quantize;
+    ThereminEngine engine(cfg);
+    engine.beginOffline();
+    engine.processBlock(s_trace, s_out, TRACE_LEN, 0);
+
+    ReplayCounts c = {0, 0, engine.getQuantizerStats()};
+    for (int i = 1; i < TRACE_LEN; i++) {
+        bool looking = s_out[i].looking != s_out[i - 1].looking;
+        bool duty = s_out[i].duty != s_out[i - 1].duty;
+        c.frames += looking;
+        c.packets += looking || duty;
+    }
+    return c;
+}
+
+static void compare(float drift, const char* label) {
+    makeHoverTrace(drift);
+    ReplayCounts raw = replay(false);
+    ReplayCounts quant = replay(true);
+
+    char msg[192];
+    snprintf(msg, sizeof(msg), "%s: frames %lu -> %lu (-%lu), packets %lu -> %lu (-%lu)",
+             label, (unsigned long)raw.frames, (unsigned long)quant.frames,
+             (unsigned long)(raw.frames - quant.frames), (unsigned long)raw.packets,
+             (unsigned long)quant.packets, (unsigned long)(raw.packets - quant.packets));
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "%s: quantizer looking %lu/%lu duty %lu/%lu (emitted/suppressed)",
+             label, (unsigned long)quant.stats.lookingEmitted, (unsigned long)quant.stats.lookingSuppressed,
+             (unsigned long)quant.stats.dutyEmitted, (unsigned long)quant.stats.dutySuppressed);
+    TEST_MESSAGE(msg);
+
+    // 悬停时原始输出在相邻级/占空比间抖动，量化后应明显减少
+    TEST_ASSERT_GREATER_THAN_UINT32(0, raw.frames);
+    TEST_ASSERT_LESS_THAN_UINT32(raw.frames, quant.frames);
+    TEST_ASSERT_LESS_THAN_UINT32(raw.packets, quant.packets);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, quant.stats.lookingSuppressed + quant.stats.dutySuppressed);
+}
+
+static void test_steady_hover(void) {
+    compare(0.0f, "steady hover");
+}
+
+// 缓慢漂移的悬停: 真实的级变化仍需输出，只抑制边界附近的抖动
+static void test_drifting_hover(void) {
+    compare(1.5f, "drifting hover");
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_hover);
+    RUN_TEST(test_drifting_hover);
+    return UNITY_END();
+}
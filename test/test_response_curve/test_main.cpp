@@ -0,0 +1,118 @@
+// 响应曲线: 死区 (deltaFMin 以下输出0)、拟合单调性、NVS 保存/读取与版本不符拒绝
+// 运行: pio test -e native -f test_response_curve -v  (输出拟合后的查找表与各 delta 的映射值)
+
+#include <unity.h>
+#include "test_support.h"
+#include "ResponseCurve.h"
+
+void setUp(void) {
+    host::beginTest(config);
+}
+
+void tearDown(void) {}
+
+// 模拟一次扫动: 空闲噪声 (0.5-2 Hz) 与偏向近距离的手部扫动 (delta 集中在低端)
+static void sweep(ResponseCurve& curve) {
+    curve.beginSweep();
+    for (int i = 0; i < 200; i++) curve.addSample(0.5f + 1.5f * (i % 10) / 10.0f);
+    for (int i = 0; i < 400; i++) {
+        float t = i / 400.0f;
+        curve.addSample(1.5f + 20.0f * t * t * t * t);
+    }
+}
+
+static void test_dead_zone_maps_to_zero(void) {
+    ThereminConfig cfg;
+    ResponseCurve curve(cfg);
+    sweep(curve);
+    TEST_ASSERT_TRUE(curve.finishSweep());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, cfg.deltaFMin, curve.getMinDelta());
+
+    // 空闲噪声与死区内的 delta 不动眼睛 (与线性映射一致)
+    for (float d = 0; d <= cfg.deltaFMin; d += 0.25f) {
+        TEST_ASSERT_EQUAL_FLOAT(0.0f, curve.map(d));
+    }
+    TEST_ASSERT_GREATER_THAN(0.0f, curve.map(cfg.deltaFMin + 0.5f));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, curve.map(curve.getMaxDelta() + 5.0f));
+
+    char msg[160];
+    int n = snprintf(msg, sizeof(msg), "range %.1f..%.1f Hz, table:", curve.getMinDelta(), curve.getMaxDelta());
+    for (int j = 0; j < ResponseCurve::LUT_SIZE && n < (int)sizeof(msg) - 5; j++) {
+        n += snprintf(msg + n, sizeof(msg) - n, " %d", curve.getTable()[j]);
+    }
+    TEST_MESSAGE(msg);
+}
+
+static void test_monotonic(void) {
+    ThereminConfig cfg;
+    ResponseCurve curve(cfg);
+    sweep(curve);
+    TEST_ASSERT_TRUE(curve.finishSweep());
+
+    for (int j = 1; j < ResponseCurve::LUT_SIZE; j++) {
+        TEST_ASSERT_GREATER_OR_EQUAL(curve.getTable()[j - 1], curve.getTable()[j]);
+    }
+    float prev = 0;
+    for (float d = 0; d < curve.getMaxDelta() + 2.0f; d += 0.1f) {
+        float v = curve.map(d);
+        TEST_ASSERT_TRUE(v >= prev);
+        prev = v;
+    }
+}
+
+// 只有死区内的样本 (无手) 时拒绝拟合
+static void test_rejects_noise_only_sweep(void) {
+    ThereminConfig cfg;
+    ResponseCurve curve(cfg);
+    curve.beginSweep();
+    for (int i = 0; i < 1000; i++) curve.addSample(0.5f + 3.0f * (i % 10) / 10.0f);
+    TEST_ASSERT_FALSE(curve.finishSweep());
+    TEST_ASSERT_FALSE(curve.isValid());
+}
+
+static void test_save_load_round_trip(void) {
+    ThereminConfig cfg;
+    ResponseCurve curve(cfg);
+    TEST_ASSERT_FALSE(curve.begin());   // 尚无曲线，NVS 已打开
+    sweep(curve);
+    TEST_ASSERT_TRUE(curve.finishSweep());
+    TEST_ASSERT_TRUE(curve.save());
+
+    ResponseCurve loaded(cfg);
+    TEST_ASSERT_TRUE(loaded.begin());
+    TEST_ASSERT_TRUE(loaded.isValid());
+    TEST_ASSERT_EQUAL_FLOAT(curve.getMinDelta(), loaded.getMinDelta());
+    TEST_ASSERT_EQUAL_FLOAT(curve.getMaxDelta(), loaded.getMaxDelta());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(curve.getTable(), loaded.getTable(), ResponseCurve::LUT_SIZE);
+    for (float d = 0; d < 25.0f; d += 0.7f) {
+        TEST_ASSERT_EQUAL_FLOAT(curve.map(d), loaded.map(d));
+    }
+}
+
+// 版本不符的记录 (记录格式变化后) 不被加载，需重新校准
+static void test_rejects_other_version(void) {
+    ThereminConfig cfg;
+    ResponseCurve curve(cfg);
+    curve.begin();
+    sweep(curve);
+    TEST_ASSERT_TRUE(curve.finishSweep());
+    TEST_ASSERT_TRUE(curve.save());
+
+    std::vector<uint8_t>& rec = host::nvs["theremin/curve"];
+    rec[4] = 2;     // CurveRecord.version (小端)
+    rec[5] = 0;
+
+    ResponseCurve loaded(cfg);
+    TEST_ASSERT_FALSE(loaded.begin());
+    TEST_ASSERT_FALSE(loaded.isValid());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_dead_zone_maps_to_zero);
+    RUN_TEST(test_monotonic);
+    RUN_TEST(test_rejects_noise_only_sweep);
+    RUN_TEST(test_save_load_round_trip);
+    RUN_TEST(test_rejects_other_version);
+    return UNITY_END();
+}
@@ -0,0 +1,131 @@
+// 影子管线保真度: 与主引擎配置相同时影子必须逐样本一致 (热启动、按键重校准、空闲采样周期)
+// 运行: pio test -e native -f test_shadow -v  (输出各场景的对比样本数与最大基线差)
+
+#include <unity.h>
+#include "test_support.h"
+#include "ShadowPipeline.h"
+
+static const float BASE = 20000.0f;
+
+static ThereminConfig s_cfg;
+static ThereminConfig s_shadowCfg;
+
+void setUp(void) {
+    host::beginTest(s_cfg);
+    s_cfg.enableResponseCurve = false;
+    s_cfg.idlePowerEnable = false;
+}
+
+void tearDown(void) {}
+
+// 一个采样周期: 主引擎处理 (与主循环相同的顺序)，影子镜像同一样本
+static void step(ThereminEngine& engine, ShadowPipeline& shadow, float countPerPeriod) {
+    host::sampleStep(engine, s_cfg, countPerPeriod);
+    engine.runSpectralAnalysis();
+    shadow.processSample(shadow.capture(engine, millis()));
+}
+
+// 12 Hz 干扰 + 噪声，周期性的手部接近
+static float input(int n) {
+    float hand = ((n / 300) % 2) ? 8.0f : 0.0f;
+    return BASE - hand + 2.0f * sinf(2.0f * (float)M_PI * 12.0f * n * s_cfg.samplingPeriodMs / 1000.0f) +
+           host::noise(0.5f);
+}
+
+static void assertIdentical(const ShadowPipeline& shadow, const ThereminEngine& engine, const char* label) {
+    const DivergenceStats& st = shadow.getStats();
+    TEST_ASSERT_GREATER_THAN_UINT32(0, st.samples);
+    TEST_ASSERT_EQUAL_UINT32(0, st.lookingDisagree);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.0f, st.maxBaselineDrift);
+    TEST_ASSERT_EQUAL_INT(engine.getSamplingPeriodMs(), shadow.getEngine().getSamplingPeriodMs());
+    TEST_ASSERT_EQUAL_INT(engine.getNotchCount(), shadow.getEngine().getNotchCount());
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s: %lu samples compared, looking disagree %lu, max baseline drift %.4f",
+             label, (unsigned long)st.samples, (unsigned long)st.lookingDisagree, st.maxBaselineDrift);
+    TEST_MESSAGE(msg);
+}
+
+// 复位后主引擎从 RTC 快照热启动，影子使用同一快照
+static void test_mirrors_warm_start(void) {
+    {
+        ThereminEngine cold(s_cfg);
+        TEST_ASSERT_TRUE(cold.begin());
+        for (int i = 0; i < 2000; i++) {
+            host::advanceMs(s_cfg.samplingPeriodMs);
+            host::pcntCount = (int)BASE;
+            host::fireTimer();
+            cold.process();
+        }
+        TEST_ASSERT_TRUE(cold.isBaselineSet());
+    }
+
+    host::reset();
+    host::serialMuted = true;
+    ThereminEngine engine(s_cfg);
+    TEST_ASSERT_TRUE(engine.begin());
+    TEST_ASSERT_TRUE(engine.hasWarmSnapshot());
+    s_shadowCfg = s_cfg;
+    ShadowPipeline shadow(s_shadowCfg);
+    shadow.begin(engine);               // 主机上无调度器: 队列/任务创建失败，离线对比不受影响
+
+    for (int n = 0; n < 1500; n++) step(engine, shadow, input(n));
+    TEST_ASSERT_TRUE(engine.isWarmStarted());
+    TEST_ASSERT_TRUE(shadow.getEngine().isWarmStarted());
+    assertIdentical(shadow, engine, "warm start");
+}
+
+// 手在场时短按校准: 主引擎重校准基线，影子在同一样本处镜像
+static void test_mirrors_button_recalibration(void) {
+    s_cfg.warmStartEnable = false;      // 不使用前一用例留下的 RTC 快照
+    ThereminEngine engine(s_cfg);
+    TEST_ASSERT_TRUE(engine.begin());
+    s_shadowCfg = s_cfg;
+    ShadowPipeline shadow(s_shadowCfg);
+    shadow.begin(engine);
+
+    int n = 0;
+    for (; n < 1500; n++) step(engine, shadow, input(n));
+    TEST_ASSERT_TRUE(engine.isBaselineSet());
+
+    for (int press = 0; press < 3; press++) {
+        host::setPin(s_cfg.buttonPin, LOW);
+        for (int i = 0; i < 10; i++, n++) step(engine, shadow, BASE - 6.0f + host::noise(0.5f));
+        host::setPin(s_cfg.buttonPin, HIGH);
+        for (int i = 0; i < 200; i++, n++) step(engine, shadow, input(n));
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, engine.getRecalibrationCount());
+    TEST_ASSERT_EQUAL_UINT32(3, shadow.getEngine().getRecalibrationCount());
+    assertIdentical(shadow, engine, "recalibration");
+}
+
+// 空闲时主引擎加长采样周期，影子随之切换 (频谱采样率与陷波器重新学习)
+static void test_mirrors_idle_sampling_period(void) {
+    s_cfg.warmStartEnable = false;
+    s_cfg.idlePowerEnable = true;
+    s_cfg.idleTimeoutMs = 5000;
+    ThereminEngine engine(s_cfg);
+    TEST_ASSERT_TRUE(engine.begin());
+    s_shadowCfg = s_cfg;
+    ShadowPipeline shadow(s_shadowCfg);
+    shadow.begin(engine);
+
+    int n = 0;
+    for (; n < 2000 && !engine.isIdle(); n++) step(engine, shadow, BASE + host::noise(0.5f));
+    TEST_ASSERT_TRUE(engine.isIdle());
+    TEST_ASSERT_NOT_EQUAL(s_cfg.samplingPeriodMs, engine.getSamplingPeriodMs());
+    TEST_ASSERT_EQUAL_INT(engine.getSamplingPeriodMs(), shadow.getEngine().getSamplingPeriodMs());
+
+    for (int i = 0; i < 300; i++, n++) step(engine, shadow, BASE + host::noise(0.5f));
+    for (int i = 0; i < 50; i++, n++) step(engine, shadow, BASE - 8.0f + host::noise(0.5f));
+    TEST_ASSERT_FALSE(engine.isIdle());
+    assertIdentical(shadow, engine, "idle period");
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_mirrors_warm_start);
+    RUN_TEST(test_mirrors_button_recalibration);
+    RUN_TEST(test_mirrors_idle_sampling_period);
+    return UNITY_END();
+}
@@ -0,0 +1,202 @@
+// 频谱干扰分析: 稳定干扰峰识别、手部运动频段排除、陷波衰减，以及引擎内自动陷波的效果
+// 运行: pio test -e native -f test_spectral -v  (输出识别延迟、残余幅度、jitterLookingChanges 与分析阶段耗时)
+
+#include <unity.h>
+#include "SpectralAnalyzer.h"
+#include "test_support.h"
+
+static const float FS = 1000.0f / SAMPLING_PERIOD_MS;
+
+static float sample(int n, float hz, float amplitude) {
+    return 20000.0f + amplitude * sinf(2.0f * (float)M_PI * hz * n / FS) + host::noise(0.5f);
+}
+
+void setUp(void) {
+    host::beginTest(config);
+}
+
+void tearDown(void) {}
+
+// 向分析器送入样本直到识别出稳定峰，返回样本数 (未识别返回 -1)
+static int detect(SpectralAnalyzer& sa, float hz, float amplitude, int maxSamples, float& peakHz) {
+    float peaks[NOTCH_MAX];
+    for (int n = 0; n < maxSamples; n++) {
+        sa.push(sample(n, hz, amplitude));
+        if (sa.frameReady() && sa.analyze(FS, peaks, NOTCH_MAX) > 0) {
+            peakHz = peaks[0];
+            return n + 1;
+        }
+    }
+    return -1;
+}
+
+static void test_detects_stable_interference(void) {
+    SpectralAnalyzer sa;
+    TEST_ASSERT_TRUE(sa.begin());
+    float peakHz = 0;
+    int samples = detect(sa, 12.5f, 3.0f, 2000, peakHz);
+    TEST_ASSERT_GREATER_THAN(0, samples);
+    TEST_ASSERT_FLOAT_WITHIN(FS / SpectralAnalyzer::FFT_SIZE, 12.5f, peakHz);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "12.5 Hz detected at %.2f Hz after %d samples (%.2f s), fft max %lu us",
+             peakHz, samples, samples / FS, (unsigned long)sa.getMaxFftMicros());
+    TEST_MESSAGE(msg);
+}
+
+// 低于 spectrumMinHz 的周期性变化 (手部来回运动) 不判为干扰
+static void test_ignores_hand_band(void) {
+    SpectralAnalyzer sa;
+    sa.begin();
+    float peakHz = 0;
+    TEST_ASSERT_EQUAL_INT(-1, detect(sa, SPECTRUM_MIN_HZ * 0.5f, 5.0f, 2000, peakHz));
+}
+
+// 纯噪声不产生峰
+static void test_no_peak_in_noise(void) {
+    SpectralAnalyzer sa;
+    sa.begin();
+    float peakHz = 0;
+    TEST_ASSERT_EQUAL_INT(-1, detect(sa, 12.5f, 0.0f, 2000, peakHz));
+}
+
+// 陷波器: 中心频率处衰减 > 30dB，直流增益为 1 (不影响基线)
+static void test_notch_response(void) {
+    NotchFilter nf;
+    nf.configure(12.5f, FS, NOTCH_Q);
+    nf.prime(20000.0f);
+    float maxResidual = 0;
+    for (int n = 0; n < 500; n++) {
+        float y = nf.process(20000.0f + 3.0f * sinf(2.0f * (float)M_PI * 12.5f * n / FS));
+        if (n > 100) maxResidual = fmaxf(maxResidual, fabsf(y - 20000.0f));
+    }
+    TEST_ASSERT_LESS_THAN(3.0f * 0.03f, maxResidual);
+
+    NotchFilter dc;
+    dc.configure(12.5f, FS, NOTCH_Q);
+    dc.prime(20000.0f);
+    for (int n = 0; n < 50; n++) TEST_ASSERT_FLOAT_WITHIN(0.01f, 20000.0f, dc.process(20000.0f));
+}
+
+// 引擎: 12.5Hz 干扰下运行，自动陷波后 smoothedDelta 的波动明显下降
+static float runEngine(bool notch, int& notchCount) {
+    ThereminConfig cfg;
+    cfg.enableSpectralNotch = notch;
+    cfg.enableResponseCurve = false;
+    ThereminEngine engine(cfg);
+    engine.beginOffline();
+    host::seed = 7;
+
+    const int n = 3000, measureFrom = 2000;
+    float peak = 0;
+    for (int i = 0; i < n; i++) {
+        float count = sample(i, 12.5f, 4.0f);
+        EngineOutput out;
+        engine.processBlock(&count, &out, 1, i * SAMPLING_PERIOD_MS);
+        engine.runSpectralAnalysis();
+        if (i >= measureFrom) peak = fmaxf(peak, out.smoothedDelta);
+    }
+    notchCount = engine.getNotchCount();
+    return peak;
+}
+
+static void test_engine_auto_notch_reduces_delta_ripple(void) {
+    int withCount = 0, withoutCount = 0;
+    float without = runEngine(false, withoutCount);
+    float with = runEngine(true, withCount);
+    TEST_ASSERT_EQUAL_INT(0, withoutCount);
+    TEST_ASSERT_EQUAL_INT(1, withCount);
+    TEST_ASSERT_LESS_THAN(without * 0.5f, with);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "peak smoothedDelta with 4.0 amplitude 12.5 Hz hum: %.2f without notch, %.2f with",
+             without, with);
+    TEST_MESSAGE(msg);
+}
+
+// 手在天线前缓慢摆动 (delta 3-9) 叠加 12.5Hz 干扰: 干扰在级边界附近翻转 looking。
+// 统计手到达后的 jitterLookingChanges (环境抖动期间的 looking 变化)，陷波后应明显减少
+static uint32_t runSwayingHover(bool notch, uint32_t& lookingChanges) {
+    ThereminConfig cfg;
+    cfg.enableSpectralNotch = notch;
+    cfg.enableResponseCurve = false;
+    ThereminEngine engine(cfg);
+    engine.beginOffline();
+    host::seed = 7;
+
+    const int n = 9000, handFrom = 1500;
+    uint32_t before = 0;
+    uint8_t last = 0;
+    lookingChanges = 0;
+    for (int i = 0; i < n; i++) {
+        float hand = i >= handFrom ? 6.0f + 3.0f * sinf(2.0f * (float)M_PI * 0.2f * i / FS) : 0.0f;
+        float count = sample(i, 12.5f, 6.0f) - hand;
+        EngineOutput out;
+        engine.processBlock(&count, &out, 1, i * SAMPLING_PERIOD_MS);
+        engine.runSpectralAnalysis();
+        if (i == handFrom) before = engine.getJitterLookingChanges();
+        if (i > handFrom && out.looking != last) lookingChanges++;
+        last = out.looking;
+    }
+    return engine.getJitterLookingChanges() - before;
+}
+
+static void test_engine_auto_notch_reduces_jitter_looking_changes(void) {
+    uint32_t withoutLooking, withLooking;
+    uint32_t without = runSwayingHover(false, withoutLooking);
+    uint32_t with = runSwayingHover(true, withLooking);
+    TEST_ASSERT_GREATER_THAN_UINT32(10, without);
+    TEST_ASSERT_LESS_THAN_UINT32(without / 4, with);
+    TEST_ASSERT_LESS_THAN_UINT32(withoutLooking, withLooking);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "swaying hover with 6.0 amplitude 12.5 Hz hum: jitter looking changes %lu -> %lu, "
+             "looking changes %lu -> %lu (without -> with notch)",
+             (unsigned long)without, (unsigned long)with, (unsigned long)withoutLooking, (unsigned long)withLooking);
+    TEST_MESSAGE(msg);
+}
+
+// 分析阶段 (FFT + 峰值跟踪 + 陷波器设计) 每次调用的最坏耗时；采样路径只复制帧
+static void test_analysis_stage_cost(void) {
+    ThereminConfig cfg;
+    cfg.enableResponseCurve = false;
+    ThereminEngine engine(cfg);
+    engine.beginOffline();
+    host::seed = 7;
+
+    const int n = 3000;
+    uint32_t maxAnalysisUs = 0, maxSampleUs = 0;
+    uint64_t totalAnalysisUs = 0, totalSampleUs = 0;
+    for (int i = 0; i < n; i++) {
+        float count = sample(i, 12.5f, 4.0f);
+        EngineOutput out;
+        uint32_t t0 = micros();
+        engine.processBlock(&count, &out, 1, i * SAMPLING_PERIOD_MS);
+        uint32_t t1 = micros();
+        engine.runSpectralAnalysis();
+        uint32_t t2 = micros();
+        maxSampleUs = max(maxSampleUs, t1 - t0);
+        maxAnalysisUs = max(maxAnalysisUs, t2 - t1);
+        totalSampleUs += t1 - t0;
+        totalAnalysisUs += t2 - t1;
+    }
+    TEST_ASSERT_EQUAL_INT(1, engine.getNotchCount());
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "per call (host, mean/max): analysis stage %.2f/%lu us, sampling path %.2f/%lu us",
+             (double)totalAnalysisUs / n, (unsigned long)maxAnalysisUs,
+             (double)totalSampleUs / n, (unsigned long)maxSampleUs);
+    TEST_MESSAGE(msg);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_detects_stable_interference);
+    RUN_TEST(test_ignores_hand_band);
+    RUN_TEST(test_no_peak_in_noise);
+    RUN_TEST(test_notch_response);
+    RUN_TEST(test_engine_auto_notch_reduces_delta_ripple);
+    RUN_TEST(test_engine_auto_notch_reduces_jitter_looking_changes);
+    RUN_TEST(test_analysis_stage_cost);
+    return UNITY_END();
+}
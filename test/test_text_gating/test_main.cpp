@@ -0,0 +1,73 @@
+// 遥测开启时串口只输出二进制帧: 基线建立、陷波重配置、空闲进入/退出、曲线校准都不得输出文本
+// 运行: pio test -e native -f test_text_gating -v
+
+#include <unity.h>
+#include "test_support.h"
+
+static ThereminConfig s_cfg;
+static const float BASE = 8000.0f;
+
+void setUp(void) {
+    host::beginTest(s_cfg);
+    s_cfg.warmStartEnable = false;
+    s_cfg.idleTimeoutMs = 5000;
+    s_cfg.curveSweepMs = 2000;
+}
+
+void tearDown(void) {}
+
+static void step(ThereminEngine& engine, float countPerPeriod) {
+    host::sampleStep(engine, s_cfg, countPerPeriod);
+    engine.runSpectralAnalysis();
+}
+
+// 12 Hz 干扰: 触发陷波器配置 (及其文本报告)
+static float interference(int n) {
+    return 1.5f * sinf(2.0f * (float)M_PI * 12.0f * n * s_cfg.samplingPeriodMs / 1000.0f);
+}
+
+// 基线建立 → 干扰陷波 → 空闲进入/退出 → 长按曲线校准扫动；返回期间输出的文本行数
+static uint32_t runSession(bool telemetryOn) {
+    telemetry.setFieldMask(telemetryOn ? TELEMETRY_PRESET_SIMPLE : 0);
+    ThereminEngine engine(s_cfg);
+    TEST_ASSERT_TRUE(engine.begin());
+    uint32_t before = host::serialLines;
+
+    int n = 0;
+    for (; n < 2000 && (!engine.isBaselineSet() || engine.getNotchCount() == 0); n++) {
+        step(engine, BASE + interference(n));
+    }
+    TEST_ASSERT_GREATER_THAN(0, engine.getNotchCount());
+    for (; n < 4000 && !engine.isIdle(); n++) step(engine, BASE + interference(n));
+    TEST_ASSERT_TRUE(engine.isIdle());
+    for (int i = 0; i < 10; i++, n++) step(engine, BASE - 10.0f);
+    TEST_ASSERT_FALSE(engine.isIdle());
+
+    host::setPin(s_cfg.buttonPin, LOW);
+    for (int i = 0; i < (int)(s_cfg.curveLongPressMs / s_cfg.samplingPeriodMs) + 5; i++, n++) {
+        step(engine, BASE);
+    }
+    TEST_ASSERT_TRUE(engine.isCalibratingCurve());
+    host::setPin(s_cfg.buttonPin, HIGH);
+    for (int i = 0; i < 200; i++, n++) step(engine, BASE - 10.0f * (i % 50) / 50.0f);
+    TEST_ASSERT_FALSE(engine.isCalibratingCurve());
+
+    return host::serialLines - before;
+}
+
+// 对照: 遥测关闭时上述事件都有文本输出
+static void test_text_when_telemetry_off(void) {
+    TEST_ASSERT_GREATER_OR_EQUAL(5, runSession(false));
+}
+
+static void test_no_text_when_telemetry_on(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, runSession(true));
+}
+
+int main(int argc, char** argv) {
+    telemetry.begin();                  // 主机上无调度器: 流缓冲可用，输出任务创建失败
+    UNITY_BEGIN();
+    RUN_TEST(test_text_when_telemetry_off);
+    RUN_TEST(test_no_text_when_telemetry_on);
+    return UNITY_END();
+}
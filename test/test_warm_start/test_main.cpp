@@ -0,0 +1,175 @@
+// 热启动仿真: 冷启动 → 软复位 (RTC快照) → 快照失配回退；以及NVS写入不在采样路径上执行、失败后重写
+// 运行: pio test -e native -f test_warm_start -v  (输出冷/热启动到首次有效基线的时间)
+
+#include <unity.h>
+#include "test_support.h"
+
+static const float BASE_COUNT = 20000.0f;
+
+static ThereminConfig s_cfg;
+
+void setUp(void) {
+    host::beginTest(s_cfg);
+    s_cfg.enableSpectralNotch = false;
+    s_cfg.enableResponseCurve = false;
+    s_cfg.idlePowerEnable = false;
+}
+
+void tearDown(void) {}
+
+// 上电/复位后运行直到基线建立，返回样本数 (超过 maxSamples 返回 -1)
+static int bootUntilBaseline(ThereminEngine& engine, float count, int maxSamples) {
+    host::nowMs = 1000;                 // 复位后 millis() 从头计数 (留出启动时间)
+    TEST_ASSERT_TRUE(engine.begin());
+    for (int i = 1; i <= maxSamples; i++) {
+        host::sampleStep(engine, s_cfg, count);
+        if (engine.isBaselineSet()) return i;
+    }
+    return -1;
+}
+
+static void test_cold_then_warm_boot(void) {
+    host::resetNvs();
+
+    // 首次上电: RTC/NVS均无快照，走冷启动
+    ThereminEngine cold(s_cfg);
+    int coldSamples = bootUntilBaseline(cold, BASE_COUNT, 2000);
+    TEST_ASSERT_GREATER_THAN(0, coldSamples);
+    TEST_ASSERT_FALSE(cold.isWarmStarted());
+    unsigned long coldMs = cold.getTimeToBaselineMs();
+
+    // 稳定运行一段时间，让RTC快照写入
+    for (int i = 0; i < 200; i++) host::sampleStep(cold, s_cfg, BASE_COUNT);
+
+    // 软复位: 新实例从RTC快照恢复，只需 warmStartSamples 个一致样本
+    ThereminEngine warm(s_cfg);
+    int warmSamples = bootUntilBaseline(warm, BASE_COUNT + 3.0f, 2000);
+    TEST_ASSERT_TRUE(warm.isWarmStarted());
+    TEST_ASSERT_EQUAL_INT(s_cfg.warmStartSamples, warmSamples);
+    unsigned long warmMs = warm.getTimeToBaselineMs();
+    TEST_ASSERT_EQUAL_UINT32((unsigned long)warmSamples * s_cfg.samplingPeriodMs, warmMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, cold.getFrozenBaseFreq(), warm.getFrozenBaseFreq());
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "time to baseline: cold %lu ms (%d samples), warm %lu ms (%d samples)",
+             coldMs, coldSamples, warmMs, warmSamples);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_THAN(coldMs, warmMs);
+}
+
+// 复位后天线环境已变化 (超出 warmStartTolerance): 放弃快照，按冷启动重新建立
+static void test_snapshot_mismatch_falls_back_to_cold(void) {
+    host::resetNvs();
+    {
+        // 先在 BASE_COUNT 处冷启动并运行，留下 RTC 快照 (不依赖其他用例的执行顺序)
+        ThereminEngine seed(s_cfg);
+        TEST_ASSERT_GREATER_THAN(0, bootUntilBaseline(seed, BASE_COUNT, 2000));
+        for (int i = 0; i < 200; i++) host::sampleStep(seed, s_cfg, BASE_COUNT);
+    }
+
+    ThereminEngine engine(s_cfg);
+    float moved = BASE_COUNT + s_cfg.warmStartTolerance * 3;
+    host::nowMs = 1000;
+    TEST_ASSERT_TRUE(engine.begin());
+    TEST_ASSERT_TRUE(engine.hasWarmSnapshot());     // 快照确实待确认，随后因失配被放弃
+    int samples = -1;
+    for (int i = 1; i <= 2000 && samples < 0; i++) {
+        host::sampleStep(engine, s_cfg, moved);
+        if (engine.isBaselineSet()) samples = i;
+    }
+    TEST_ASSERT_GREATER_THAN(s_cfg.warmStartSamples, samples);
+    TEST_ASSERT_FALSE(engine.isWarmStarted());
+    TEST_ASSERT_FLOAT_WITHIN(5.0f, moved, engine.getFrozenBaseFreq());
+    TEST_ASSERT_GREATER_THAN(0, engine.getTimeToBaselineMs());
+}
+
+// 采样路径 (process) 从不直接写NVS: 写入只排队，由低优先级任务执行
+static void test_nvs_write_deferred_from_sampling_path(void) {
+    host::resetNvs();
+    ThereminEngine engine(s_cfg);
+    TEST_ASSERT_GREATER_THAN(0, bootUntilBaseline(engine, BASE_COUNT, 2000));
+    for (int i = 0; i < 2000; i++) host::sampleStep(engine, s_cfg, BASE_COUNT);
+    engine.recalibrate();               // 手动校准强制保存
+    TEST_ASSERT_EQUAL_UINT32(0, host::nvsWrites);
+}
+
+// BaselineStore 节流: 首次保存排队，间隔内/变化不足不再排队，flushPending 才真正写入
+static void test_store_throttle_and_flush(void) {
+    host::resetNvs();
+    BaselineStore store(s_cfg);
+    TEST_ASSERT_TRUE(store.begin());
+
+    BaselineSnapshot snap;
+    snap.frozenBaseFreq = snap.smoothedBaseFreq = snap.smoothedFreq = BASE_COUNT;
+
+    store.save(snap, 1000);
+    TEST_ASSERT_TRUE(store.hasPendingWrite());
+    TEST_ASSERT_EQUAL_UINT32(0, host::nvsWrites);
+    store.flushPending();
+    TEST_ASSERT_FALSE(store.hasPendingWrite());
+    TEST_ASSERT_EQUAL_UINT32(1, host::nvsWrites);
+
+    // 间隔未到: 即使基线变化也不写 (非强制)
+    snap.frozenBaseFreq += s_cfg.snapshotNvsMinChange * 2;
+    store.save(snap, 2000);
+    TEST_ASSERT_FALSE(store.hasPendingWrite());
+
+    // 强制 (手动校准): 跳过时间节流
+    store.save(snap, 3000, true);
+    TEST_ASSERT_TRUE(store.hasPendingWrite());
+    store.flushPending();
+
+    // 间隔已到但变化不足: 不写
+    snap.frozenBaseFreq += s_cfg.snapshotNvsMinChange * 0.5f;
+    store.save(snap, 3000 + s_cfg.snapshotNvsInterval);
+    TEST_ASSERT_FALSE(store.hasPendingWrite());
+    TEST_ASSERT_EQUAL_UINT32(2, store.getNvsWriteCount());
+
+    // NVS中保存的是最后一次写入 (强制保存) 的快照
+    const std::vector<uint8_t>& stored = host::nvs["theremin/baseline"];
+    TEST_ASSERT_EQUAL(sizeof(BaselineSnapshot), stored.size());
+    BaselineSnapshot written;
+    memcpy(&written, stored.data(), sizeof(written));
+    TEST_ASSERT_EQUAL_FLOAT(BASE_COUNT + s_cfg.snapshotNvsMinChange * 2, written.frozenBaseFreq);
+}
+
+// NVS 写入失败: 下一次时间节流到期的保存重写，即使基线变化不足 snapshotNvsMinChange
+static void test_store_retries_failed_write(void) {
+    host::resetNvs();
+    BaselineStore store(s_cfg);
+    TEST_ASSERT_TRUE(store.begin());
+
+    BaselineSnapshot snap;
+    snap.frozenBaseFreq = snap.smoothedBaseFreq = snap.smoothedFreq = BASE_COUNT;
+
+    host::nvsFailWrites = 1;
+    store.save(snap, 1000);
+    store.flushPending();
+    TEST_ASSERT_EQUAL_UINT32(1, store.getNvsFailureCount());
+    TEST_ASSERT_EQUAL_UINT32(0, host::nvsWrites);
+
+    // 间隔未到: 仍按时间节流
+    store.save(snap, 2000);
+    TEST_ASSERT_FALSE(store.hasPendingWrite());
+
+    // 间隔已到: 基线未变也重写
+    store.save(snap, 1000 + s_cfg.snapshotNvsInterval);
+    TEST_ASSERT_TRUE(store.hasPendingWrite());
+    store.flushPending();
+    TEST_ASSERT_EQUAL_UINT32(1, store.getNvsWriteCount());
+    TEST_ASSERT_EQUAL(sizeof(BaselineSnapshot), host::nvs["theremin/baseline"].size());
+
+    // 写入成功后恢复变化量门限
+    store.save(snap, 1000 + 2 * s_cfg.snapshotNvsInterval);
+    TEST_ASSERT_FALSE(store.hasPendingWrite());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cold_then_warm_boot);
+    RUN_TEST(test_snapshot_mismatch_falls_back_to_cold);
+    RUN_TEST(test_nvs_write_deferred_from_sampling_path);
+    RUN_TEST(test_store_throttle_and_flush);
+    RUN_TEST(test_store_retries_failed_write);
+    return UNITY_END();
+}
@@ -0,0 +1,73 @@
+"""PlatformIO 构建后脚本: 按翻译单元输出 flash/静态RAM 占用
+
+platformio.ini 中以 `extra_scripts = post:tools/size_report.py` 引用。
+固件链接完成后对 $BUILD_DIR/src 下每个目标文件运行 size，
+按静态 RAM (data + bss) 降序打印，并与上一次构建的报告比较，
+变化的模块标出增量。报告同时写入 $BUILD_DIR/size_report.csv。
+"""
+
+import csv
+import os
+import subprocess
+
+Import("env")  # noqa: F821  (SCons 注入)
+
+
+def read_previous(path):
+    if not os.path.exists(path):
+        return {}
+    with open(path, newline="") as f:
+        return {row["unit"]: row for row in csv.DictReader(f)}
+
+
+def collect(size_tool, src_dir):
+    objs = []
+    for root, _, files in os.walk(src_dir):
+        objs += [os.path.join(root, f) for f in files if f.endswith(".o")]
+    if not objs:
+        return []
+    out = subprocess.run([size_tool, "-B"] + sorted(objs),
+                         capture_output=True, text=True, check=True).stdout
+    rows = []
+    for line in out.splitlines()[1:]:
+        text, data, bss, _dec, _hex, name = line.split(None, 5)
+        rows.append({
+            "unit": os.path.relpath(name, src_dir),
+            "text": int(text),
+            "data": int(data),
+            "bss": int(bss),
+        })
+    return rows
+
+
+def size_report(source, target, env):
+    build_dir = env.subst("$BUILD_DIR")
+    report_path = os.path.join(build_dir, "size_report.csv")
+    rows = collect(env.subst("$SIZETOOL"), os.path.join(build_dir, "src"))
+    if not rows:
+        return
+    previous = read_previous(report_path)
+
+    rows.sort(key=lambda r: r["data"] + r["bss"], reverse=True)
+    print("\nPer-unit size (bytes)          flash     ram    data     bss   Δflash    Δram")
+    total_flash = total_ram = 0
+    for r in rows:
+        prev = previous.get(r["unit"])
+        flash = r["text"] + r["data"]
+        ram = r["data"] + r["bss"]
+        total_flash += flash
+        total_ram += ram
+        d_flash = "" if prev is None else flash - int(prev["text"]) - int(prev["data"])
+        d_ram = "" if prev is None else ram - int(prev["data"]) - int(prev["bss"])
+        print("  %-28s %7d %7d %7d %7d %8s %7s" % (
+            r["unit"], flash, ram, r["data"], r["bss"],
+            ("%+d" % d_flash) if d_flash else "", ("%+d" % d_ram) if d_ram else ""))
+    print("  %-28s %7d %7d" % ("total (src only)", total_flash, total_ram))
+
+    with open(report_path, "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=["unit", "text", "data", "bss"])
+        writer.writeheader()
+        writer.writerows(rows)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", size_report)  # noqa: F821
@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+"""ESP32 Theremin 二进制遥测解码器
+
+将固件 Telemetry 输出的 COBS 帧流解码为 CSV 或实时曲线。
+
+用法:
+  telemetry_decode.py --port /dev/ttyACM0 --fields 7F > log.csv   # 设置字段并记录
+  telemetry_decode.py --file capture.bin --csv log.csv              # 解码录制文件
+  telemetry_decode.py --port /dev/ttyACM0 --plot smoothed_delta,looking
+  telemetry_decode.py --bench 200000                                # 解码吞吐基准
+
+帧格式见 src/Telemetry.h。字段顺序须与 TelemetryField 保持一致。
+"""
+
+import argparse
+import csv
+import struct
+import sys
+import time
+
+FIELDS = [
+    "raw_count", "smoothed_freq", "smoothed_base", "frozen_base",
+    "delta_raw", "delta", "smoothed_delta", "delta_rate",
+    "looking", "duty", "direction", "env_count",
+    "env_stable_counter", "env_jitter", "static_count", "stable_count",
+    "base_alpha", "env_factor", "hand_factor", "adaptive_alpha",
+    "notch_count", "idle", "dropped",
+]
+
+PRESETS = {
+    "alpha": ["delta_raw", "env_stable_counter", "static_count", "base_alpha",
+              "env_factor", "hand_factor", "adaptive_alpha"],
+    "plotter": ["smoothed_freq", "smoothed_base", "delta", "delta_rate"],
+    "simple": ["smoothed_freq", "smoothed_base", "delta", "looking"],
+}
+
+FRAME_TYPE_SAMPLE = 0x01
+HEADER = struct.Struct("<BHII")
+
+
+def crc16_ccitt(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    n = len(data)
+    while i < n:
+        code = data[i]
+        if code == 0:
+            raise ValueError("bad COBS code")
+        end = i + code
+        if end > n:
+            raise ValueError("truncated COBS block")
+        out += data[i + 1:end]
+        i = end
+        if code < 0xFF and i < n:
+            out.append(0)
+    return bytes(out)
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_pos = 0
+    code = 1
+    for byte in data:
+        if byte == 0:
+            out[code_pos] = code
+            code_pos = len(out)
+            out.append(0)
+            code = 1
+            continue
+        out.append(byte)
+        code += 1
+        if code == 0xFF:
+            out[code_pos] = code
+            code_pos = len(out)
+            out.append(0)
+            code = 1
+    out[code_pos] = code
+    out.append(0)
+    return bytes(out)
+
+
+def mask_fields(mask):
+    return [name for bit, name in enumerate(FIELDS) if mask & (1 << bit)]
+
+
+def parse_mask(text):
+    """字段掩码: 逗号分隔的十六进制、字段名或预设，可混合 (如 delta,7F)"""
+    mask = 0
+    for token in text.split(","):
+        token = token.strip()
+        if not token:
+            continue
+        if token in PRESETS:
+            names = PRESETS[token]
+        elif token in FIELDS:
+            names = [token]
+        else:
+            try:
+                mask |= int(token, 16)
+                continue
+            except ValueError:
+                raise argparse.ArgumentTypeError(
+                    f"unknown field '{token}'; expected hex, a preset ({', '.join(PRESETS)}) "
+                    f"or one of: {', '.join(FIELDS)}") from None
+        for n in names:
+            mask |= 1 << FIELDS.index(n)
+    return mask
+
+
+class Stats:
+    def __init__(self):
+        self.frames = 0
+        self.crc_errors = 0
+        self.format_errors = 0
+        self.lost = 0
+        self.bytes = 0
+        self.start = time.perf_counter()
+
+    def report(self, out=sys.stderr):
+        elapsed = max(time.perf_counter() - self.start, 1e-9)
+        print(f"frames={self.frames} crc_err={self.crc_errors} fmt_err={self.format_errors} "
+              f"lost={self.lost} bytes={self.bytes} "
+              f"{self.frames / elapsed:.0f} frames/s {self.bytes / elapsed / 1e6:.2f} MB/s",
+              file=out)
+
+
+class Decoder:
+    """增量解码：feed() 任意分块的字节，返回解码出的 (seq, ts, mask, values) 列表"""
+
+    def __init__(self, stats):
+        self.stats = stats
+        self.buf = bytearray()
+        self.last_seq = None
+
+    def feed(self, chunk):
+        self.stats.bytes += len(chunk)
+        self.buf += chunk
+        frames = []
+        while True:
+            end = self.buf.find(0)
+            if end < 0:
+                break
+            packet = bytes(self.buf[:end])
+            del self.buf[:end + 1]
+            if packet:
+                frame = self.decode_packet(packet)
+                if frame:
+                    frames.append(frame)
+        return frames
+
+    def decode_packet(self, packet):
+        try:
+            raw = cobs_decode(packet)
+        except ValueError:
+            self.stats.format_errors += 1
+            return None
+        if len(raw) < HEADER.size + 2:
+            self.stats.format_errors += 1
+            return None
+        body, crc = raw[:-2], struct.unpack_from("<H", raw, len(raw) - 2)[0]
+        if crc16_ccitt(body) != crc:
+            self.stats.crc_errors += 1
+            return None
+        ftype, seq, ts, mask = HEADER.unpack_from(body)
+        count = bin(mask).count("1")
+        if ftype != FRAME_TYPE_SAMPLE or len(body) != HEADER.size + 4 * count:
+            self.stats.format_errors += 1
+            return None
+        values = struct.unpack_from(f"<{count}f", body, HEADER.size)
+        if self.last_seq is not None:
+            self.stats.lost += (seq - self.last_seq - 1) & 0xFFFF
+        self.last_seq = seq
+        self.stats.frames += 1
+        return seq, ts, mask, values
+
+
+def encode_frame(seq, ts, mask, values):
+    body = HEADER.pack(FRAME_TYPE_SAMPLE, seq & 0xFFFF, ts, mask)
+    body += struct.pack(f"<{len(values)}f", *values)
+    return cobs_encode(body + struct.pack("<H", crc16_ccitt(body)))
+
+
+def run_bench(count):
+    mask = (1 << len(FIELDS)) - 1
+    values = [float(i) for i in range(len(FIELDS))]
+    stream = b"".join(encode_frame(i, i * 20, mask, values) for i in range(count))
+    stats = Stats()
+    decoder = Decoder(stats)
+    for off in range(0, len(stream), 4096):
+        decoder.feed(stream[off:off + 4096])
+    stats.report(sys.stdout)
+
+
+def open_source(args):
+    if args.port:
+        import serial  # pyserial
+        port = serial.Serial(args.port, args.baud, timeout=0.1)
+        if args.fields is not None:
+            port.write(f"T{args.fields:X}\n".encode())
+        return port.read, port
+    stream = open(args.file, "rb") if args.file else sys.stdin.buffer
+    return (lambda n: stream.read(n)), stream
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", help="串口设备")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--file", help="录制的二进制文件 (默认 stdin)")
+    parser.add_argument("--fields", type=parse_mask, help="设置字段掩码: 十六进制、字段名或预设 (alpha/plotter/simple), 逗号分隔")
+    parser.add_argument("--csv", help="CSV输出文件 (默认 stdout)")
+    parser.add_argument("--plot", help="实时曲线字段, 逗号分隔")
+    parser.add_argument("--window", type=int, default=500, help="实时曲线样本数")
+    parser.add_argument("--bench", type=int, metavar="N", help="合成 N 帧测量解码吞吐")
+    args = parser.parse_args()
+
+    if args.bench:
+        run_bench(args.bench)
+        return
+
+    read, source = open_source(args)
+    stats = Stats()
+    decoder = Decoder(stats)
+    out = open(args.csv, "w", newline="") if args.csv else sys.stdout
+    writer = csv.writer(out)
+    current_mask = None
+
+    plot = None
+    if args.plot:
+        plot = LivePlot(args.plot.split(","), args.window)
+
+    try:
+        while True:
+            chunk = read(4096)
+            if not chunk:
+                if args.port:
+                    continue
+                break
+            for seq, ts, mask, values in decoder.feed(chunk):
+                names = mask_fields(mask)
+                if mask != current_mask:
+                    writer.writerow(["seq", "timestamp_ms"] + names)
+                    current_mask = mask
+                writer.writerow([seq, ts] + [f"{v:.6g}" for v in values])
+                if plot:
+                    plot.add(ts, dict(zip(names, values)))
+            if plot:
+                plot.refresh()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        out.flush()
+        stats.report()
+
+
+class LivePlot:
+    def __init__(self, names, window):
+        import matplotlib.pyplot as plt
+        self.plt = plt
+        self.names = names
+        self.window = window
+        self.t = []
+        self.data = {n: [] for n in names}
+        plt.ion()
+        self.fig, self.ax = plt.subplots()
+        self.lines = {n: self.ax.plot([], [], label=n)[0] for n in names}
+        self.ax.legend(loc="upper left")
+        self.last_draw = 0.0
+
+    def add(self, ts, row):
+        self.t.append(ts / 1000.0)
+        for n in self.names:
+            self.data[n].append(row.get(n, float("nan")))
+        if len(self.t) > self.window:
+            del self.t[0]
+            for n in self.names:
+                del self.data[n][0]
+
+    def refresh(self):
+        now = time.monotonic()
+        if now - self.last_draw < 0.05 or not self.t:
+            return
+        self.last_draw = now
+        for n, line in self.lines.items():
+            line.set_data(self.t, self.data[n])
+        self.ax.relim()
+        self.ax.autoscale_view()
+        self.plt.pause(0.001)
+
+
+if __name__ == "__main__":
+    main()